@@ -370,6 +370,11 @@ enum packets_types {
  */
 #define LEG_TAGGED_PACKET	0
 
+/* The legacy untagged/tagged MTL queues are spread by RSS over the host
+ * owned Rx DMA channels, the other queues keep their static mapping.
+ */
+#define TC956X_RSS_MTL_QUEUES	(BIT(0) | BIT(1))
+
 /* Untagged gPTP packet */
 #define UNTAGGED_GPTP_PACKET	4	/*Not used in CPE case */
 
@@ -939,6 +944,20 @@ enum packets_types {
 #define TC956X_MSI_EVENT_OFFSET(pf_id)		(TC956X_MSI_BASE +\
 						(pf_id * TC956X_MSI_PF1) + (0x0068))
 
+/* Each MSI_VECT_SETn register maps eight interrupt sources, 4 bits each */
+#define TC956X_MSI_VECT_SET_OFFSET(pf_id, n)	(TC956X_MSI_VECT_SET0_OFFSET(pf_id) + \
+						((n) * 4))
+#define TC956X_MSI_VECT_SET_CNT			8
+#define TC956X_MSI_SRC_PER_VECT_SET		8
+#define TC956X_MSI_SRC_SHIFT(src)		(((src) % TC956X_MSI_SRC_PER_VECT_SET) * 4)
+
+/* Multi vector mode: vector 0 carries MAC/MTL/PHY and other common events,
+ * vector (1 + chan) carries both Tx and Rx interrupts of DMA channel chan.
+ */
+#define TC956X_MSI_VECTOR_MAX			16
+#define TC956X_MSI_COMMON_VECTOR		0
+#define TC956X_MSI_CH_VECTOR(chan)		(1 + (chan))
+
 #ifdef TC956X
 /* CPE usecase only TxCH 0 is applicable */
 #define HOST_BEST_EFF_CH		0 /* Legacy channel is best effort traffic */
@@ -963,8 +982,12 @@ enum packets_types {
 #endif /* End of TC956X Define */
 
 /* These need to be power of two, and >= 4 */
-#define DMA_TX_SIZE 512
-#define DMA_RX_SIZE 512
+#define DMA_MIN_TX_SIZE 64
+#define DMA_MAX_TX_SIZE 4096
+#define DMA_DEFAULT_TX_SIZE 512
+#define DMA_MIN_RX_SIZE 64
+#define DMA_MAX_RX_SIZE 4096
+#define DMA_DEFAULT_RX_SIZE 512
 #define TC956XMAC_GET_ENTRY(x, size)	((x + 1) & (size - 1))
 
 #undef FRAME_FILTER_DEBUG
@@ -1097,6 +1120,11 @@ struct tc956xmac_extra_stats {
 	/* TSO */
 	u64 tx_tso_frames[TC956XMAC_CH_MAX];
 	u64 tx_tso_nfrags[TC956XMAC_CH_MAX];
+	/* XDP */
+	u64 rx_xdp_drop[TC956XMAC_CH_MAX];
+	u64 rx_xdp_tx[TC956XMAC_CH_MAX];
+	u64 rx_xdp_redirect[TC956XMAC_CH_MAX];
+	u64 tx_xdp_xmit[TC956XMAC_CH_MAX];
 
 	/* Tx desc statistics */
 	u64 txch_status[TC956XMAC_CH_MAX];
@@ -1258,6 +1286,8 @@ enum dma_irq_status {
 	tx_hard_error_bump_tc = 0x2,
 	handle_rx = 0x4,
 	handle_tx = 0x8,
+	rx_buf_unav = 0x10,
+	dma_fatal_error = 0x20,
 };
 
 /* EEE and LPI defines */
@@ -35,6 +35,7 @@
 #include <linux/bitrev.h>
 #include <linux/crc32.h>
 #include <linux/iopoll.h>
+#include <linux/sort.h>
 #include "tc956xmac.h"
 #include "tc956xmac_ptp.h"
 #include "dwxgmac2.h"
@@ -974,6 +975,14 @@ static int dwxgmac2_rss_configure(struct tc956xmac_priv *priv,
 	if (!cfg || !cfg->enable) {
 		value &= ~XGMAC_RSSE;
 		writel(value, ioaddr + XGMAC_RSS_CTRL);
+#ifdef TC956X
+		/* Back to the static channel of each queue */
+		for (i = 0; i < num_rxq; i++) {
+			if (TC956X_RSS_MTL_QUEUES & BIT(i))
+				dwxgmac2_map_mtl_to_dma(priv, hw, i,
+						priv->plat->rx_queues_cfg[i].chan);
+		}
+#endif
 		return 0;
 	}
 
@@ -990,8 +999,14 @@ static int dwxgmac2_rss_configure(struct tc956xmac_priv *priv,
 			return ret;
 	}
 
-	for (i = 0; i < num_rxq; i++)
+	for (i = 0; i < num_rxq; i++) {
+#ifdef TC956X
+		/* gPTP, AVB and CDT queues stay on their dedicated channel */
+		if (!(TC956X_RSS_MTL_QUEUES & BIT(i)))
+			continue;
+#endif
 		dwxgmac2_map_mtl_to_dma(priv, hw, i, XGMAC_QDDMACH);
+	}
 
 	value |= XGMAC_UDP4TE | XGMAC_TCP4TE | XGMAC_IP2TE | XGMAC_RSSE;
 	writel(value, ioaddr + XGMAC_RSS_CTRL);
@@ -1623,86 +1638,255 @@ static void dwxgmac3_rxp_enable(struct tc956xmac_priv *priv, void __iomem *ioadd
 	writel(val, ioaddr + XGMAC_MTL_OPMODE);
 }
 
-static int dwxgmac3_rxp_update_single_entry(struct tc956xmac_priv *priv, void __iomem *ioaddr,
-					    struct tc956xmac_tc_entry *entry,
-					    int pos)
+static int dwxgmac3_rxp_write_word(void __iomem *ioaddr, int real_pos,
+				   u32 data)
 {
-	int ret, i;
+	int ret;
+	u32 val;
+
+	/* Wait for ready */
+	ret = readl_poll_timeout(ioaddr + XGMAC_MTL_RXP_IACC_CTRL_ST,
+			val, !(val & XGMAC_STARTBUSY), 1, 10000);
+	if (ret)
+		return ret;
+
+	/* Write data */
+	writel(data, ioaddr + XGMAC_MTL_RXP_IACC_DATA);
+
+	/* Write pos */
+	val = real_pos & XGMAC_ADDR;
+	writel(val, ioaddr + XGMAC_MTL_RXP_IACC_CTRL_ST);
+
+	/* Write OP */
+	val |= XGMAC_WRRDN;
+	writel(val, ioaddr + XGMAC_MTL_RXP_IACC_CTRL_ST);
+
+	/* Start Write */
+	val |= XGMAC_STARTBUSY;
+	writel(val, ioaddr + XGMAC_MTL_RXP_IACC_CTRL_ST);
+
+	/* Wait for done */
+	return readl_poll_timeout(ioaddr + XGMAC_MTL_RXP_IACC_CTRL_ST,
+			val, !(val & XGMAC_STARTBUSY), 1, 10000);
+}
+
+/**
+ * dwxgmac3_rxp_sync_entry - write one parser entry
+ * @priv: driver private structure
+ * @ioaddr: MAC base address
+ * @entry: new entry value
+ * @pos: table position
+ * Description: only the words that differ from the copy last written to
+ * the hardware are written, so patching an action is a single word write.
+ */
+static int dwxgmac3_rxp_sync_entry(struct tc956xmac_priv *priv,
+				   void __iomem *ioaddr,
+				   const struct tc956xmac_rx_parser_entry *entry,
+				   int pos)
+{
+	const int words = sizeof(*entry) / sizeof(u32);
+	u32 *hw = (u32 *)&priv->rxp_hw[pos];
+	const u32 *val = (const u32 *)entry;
+	int i, ret;
+
+	for (i = 0; i < words; i++) {
+		if (hw[i] == val[i])
+			continue;
 
-	for (i = 0; i < (sizeof(entry->val) / sizeof(u32)); i++) {
-		int real_pos = pos * (sizeof(entry->val) / sizeof(u32)) + i;
-		u32 val;
+		ret = dwxgmac3_rxp_write_word(ioaddr, pos * words + i, val[i]);
+		if (ret) {
+			priv->rxp_hw_valid = false;
+			return ret;
+		}
+		hw[i] = val[i];
+	}
+
+	return 0;
+}
 
-		/* Wait for ready */
-		ret = readl_poll_timeout(ioaddr + XGMAC_MTL_RXP_IACC_CTRL_ST,
-				val, !(val & XGMAC_STARTBUSY), 1, 10000);
+static int dwxgmac3_rxp_sync(struct tc956xmac_priv *priv, void __iomem *ioaddr,
+			     unsigned int base, unsigned int nve)
+{
+	unsigned int i;
+	int ret;
+
+	for (i = 0; i < nve; i++) {
+		ret = dwxgmac3_rxp_sync_entry(priv, ioaddr, &priv->rxp_next[i],
+					      base + i);
 		if (ret)
 			return ret;
+	}
+
+	return 0;
+}
 
-		/* Write data */
-		val = *((u32 *)&entry->val + i);
-		writel(val, ioaddr + XGMAC_MTL_RXP_IACC_DATA);
+static int dwxgmac3_rxp_cmp_match(const struct tc956xmac_tc_entry *a,
+				  const struct tc956xmac_tc_entry *b)
+{
+	if (a->val.frame_offset != b->val.frame_offset)
+		return a->val.frame_offset < b->val.frame_offset ? -1 : 1;
+	if (a->val.match_en != b->val.match_en)
+		return a->val.match_en < b->val.match_en ? -1 : 1;
+	if (a->val.match_data != b->val.match_data)
+		return a->val.match_data < b->val.match_data ? -1 : 1;
+	if (a->val.im != b->val.im)
+		return a->val.im < b->val.im ? -1 : 1;
 
-		/* Write pos */
-		val = real_pos & XGMAC_ADDR;
-		writel(val, ioaddr + XGMAC_MTL_RXP_IACC_CTRL_ST);
+	return 0;
+}
 
-		/* Write OP */
-		val |= XGMAC_WRRDN;
-		writel(val, ioaddr + XGMAC_MTL_RXP_IACC_CTRL_ST);
+/* Rules go by ascending prio, then in the order they were added */
+static int dwxgmac3_rxp_cmp_rules(const void *pa, const void *pb)
+{
+	const struct tc956xmac_tc_entry *a = *(struct tc956xmac_tc_entry **)pa;
+	const struct tc956xmac_tc_entry *b = *(struct tc956xmac_tc_entry **)pb;
 
-		/* Start Write */
-		val |= XGMAC_STARTBUSY;
-		writel(val, ioaddr + XGMAC_MTL_RXP_IACC_CTRL_ST);
+	if (a->prio != b->prio)
+		return a->prio < b->prio ? -1 : 1;
+	if (a->seq != b->seq)
+		return a->seq < b->seq ? -1 : 1;
 
-		/* Wait for done */
-		ret = readl_poll_timeout(ioaddr + XGMAC_MTL_RXP_IACC_CTRL_ST,
-				val, !(val & XGMAC_STARTBUSY), 1, 10000);
+	return 0;
+}
+
+/* Rules of a run sharing the same action are sorted by their matches,
+ * which puts the ones sharing a prefix next to each other.
+ */
+static int dwxgmac3_rxp_cmp_chains(const void *pa, const void *pb)
+{
+	const struct tc956xmac_tc_entry *a = *(struct tc956xmac_tc_entry **)pa;
+	const struct tc956xmac_tc_entry *b = *(struct tc956xmac_tc_entry **)pb;
+	const struct tc956xmac_tc_entry *ha = a, *hb = b;
+	int ret;
+
+	for (; a && b; a = a->frag_ptr, b = b->frag_ptr) {
+		ret = dwxgmac3_rxp_cmp_match(a, b);
 		if (ret)
 			return ret;
 	}
 
-	return 0;
+	if (a)
+		return 1;
+	if (b)
+		return -1;
+	return dwxgmac3_rxp_cmp_rules(&ha, &hb);
 }
 
 static struct tc956xmac_tc_entry *
-dwxgmac3_rxp_get_next_entry(struct tc956xmac_tc_entry *entries,
-			    unsigned int count, u32 curr_prio)
+dwxgmac3_rxp_last(struct tc956xmac_tc_entry *entry)
 {
-	struct tc956xmac_tc_entry *entry;
-	u32 min_prio = ~0x0;
-	int i, min_prio_idx;
-	bool found = false;
+	while (entry->frag_ptr)
+		entry = entry->frag_ptr;
 
-	for (i = count - 1; i >= 0; i--) {
-		entry = &entries[i];
+	return entry;
+}
 
-		/* Do not update unused entries */
-		if (!entry->in_use)
-			continue;
-		/* Do not update already updated entries (i.e. fragments) */
-		if (entry->in_hw)
-			continue;
-		/* Let last entry be updated last */
-		if (entry->is_last)
-			continue;
-		/* Do not return fragments */
-		if (entry->is_frag)
-			continue;
-		/* Check if we already checked this prio */
-		if (entry->prio < curr_prio)
-			continue;
-		/* Check if this is the minimum prio */
-		if (entry->prio < min_prio) {
-			min_prio = entry->prio;
-			min_prio_idx = i;
-			found = true;
+/* Rules with the same action give the same result whichever hits first */
+static bool dwxgmac3_rxp_same_action(struct tc956xmac_tc_entry *a,
+				     struct tc956xmac_tc_entry *b)
+{
+	a = dwxgmac3_rxp_last(a);
+	b = dwxgmac3_rxp_last(b);
+
+	return a->val.af == b->val.af && a->val.rf == b->val.rf &&
+	       a->val.dma_ch_no == b->val.dma_ch_no;
+}
+
+static unsigned int dwxgmac3_rxp_chain_len(struct tc956xmac_tc_entry *entry)
+{
+	unsigned int len = 0;
+
+	for (; entry; entry = entry->frag_ptr)
+		len++;
+
+	return len;
+}
+
+/* Number of leading fragments two rules can share: the last fragment of a
+ * rule carries its action and is never shared.
+ */
+static unsigned int dwxgmac3_rxp_prefix_len(struct tc956xmac_tc_entry *a,
+					    struct tc956xmac_tc_entry *b)
+{
+	unsigned int max = min(dwxgmac3_rxp_chain_len(a),
+			       dwxgmac3_rxp_chain_len(b)) - 1;
+	unsigned int len = 0;
+
+	for (; len < max; a = a->frag_ptr, b = b->frag_ptr, len++) {
+		if (dwxgmac3_rxp_cmp_match(a, b))
+			break;
+	}
+
+	return len;
+}
+
+/**
+ * dwxgmac3_rxp_emit_group - lay out rules sharing a prefix
+ * @priv: driver private structure
+ * @rules: heads of the rules
+ * @n: number of rules
+ * @plen: number of prefix fragments the rules share
+ * @base: table position of the first entry of the table
+ * @nve: number of entries laid out so far, updated
+ * Description: the prefix is laid out once and skips the whole group on a
+ * mismatch. Each rule follows with the rest of its chain, whose
+ * fragments skip to the next rule on a mismatch.
+ */
+static int dwxgmac3_rxp_emit_group(struct tc956xmac_priv *priv,
+				   struct tc956xmac_tc_entry **rules,
+				   unsigned int n, unsigned int plen,
+				   unsigned int base, unsigned int *nve)
+{
+	struct tc956xmac_rx_parser_entry *hw;
+	struct tc956xmac_tc_entry *frag;
+	unsigned int i, k, pos = *nve, end = *nve + plen, next;
+
+	for (i = 0; i < n; i++)
+		end += dwxgmac3_rxp_chain_len(rules[i]) - plen;
+	if (end > priv->rxp_hw_size)
+		return -ENOSPC;
+
+	for (i = 0; i < n; i++) {
+		frag = rules[i];
+
+		for (k = 0; k < plen; k++, frag = frag->frag_ptr) {
+			frag->table_pos = base + *nve + k;
+			frag->in_hw = true;
+			if (i)
+				continue;
+
+			hw = &priv->rxp_next[pos++];
+			memcpy(hw, &frag->val, sizeof(*hw));
+			hw->af = 0;
+			hw->rf = 0;
+			hw->nc = 1;
+			hw->ok_index = base + end;
+		}
+
+		next = pos + dwxgmac3_rxp_chain_len(frag);
+		if (i == n - 1)
+			next = end;
+
+		rules[i]->hw_entries = dwxgmac3_rxp_chain_len(frag);
+		rules[i]->hw_shared = plen;
+
+		for (; frag; frag = frag->frag_ptr) {
+			hw = &priv->rxp_next[pos];
+			memcpy(hw, &frag->val, sizeof(*hw));
+			if (frag->frag_ptr) {
+				hw->af = 0;
+				hw->rf = 0;
+				hw->nc = 1;
+				hw->ok_index = base + next;
+			}
+
+			frag->table_pos = base + pos++;
+			frag->in_hw = true;
 		}
 	}
 
-	if (found)
-		return &entries[min_prio_idx];
-	return NULL;
+	*nve = end;
+	return 0;
 }
 #endif /* TC956X_UNSUPPORTED_UNTESTED_FEATURE */
 
@@ -1861,66 +2045,112 @@ static int dwxgmac2_rx_parser_init(struct tc956xmac_priv *priv,
 	return 0;
 }
 #ifdef TC956X_UNSUPPORTED_UNTESTED_FEATURE
-static int dwxgmac3_rxp_config(struct tc956xmac_priv *priv, void __iomem *ioaddr,
-			       struct tc956xmac_tc_entry *entries,
-			       unsigned int count)
+/* The first two rules set the prefix, the others must share all of it and
+ * the action to join the group. Returns the end of the group starting at
+ * @i and its prefix length in @plen.
+ */
+static unsigned int dwxgmac3_rxp_group_end(struct tc956xmac_tc_entry **rules,
+					   unsigned int i, unsigned int n,
+					   unsigned int *plen)
 {
-	struct tc956xmac_tc_entry *entry, *frag;
-	int i, ret, nve = 0;
-	u32 curr_prio = 0;
-	u32 old_val, val;
+	unsigned int j, len;
 
-	/* Force disable RX */
-	old_val = readl(ioaddr + XGMAC_RX_CONFIG);
-	val = old_val & ~XGMAC_CONFIG_RE;
-	writel(val, ioaddr + XGMAC_RX_CONFIG);
+	*plen = 0;
+	for (j = i + 1; j < n; j++) {
+		if (!dwxgmac3_rxp_same_action(rules[i], rules[j]))
+			break;
+		len = dwxgmac3_rxp_prefix_len(rules[i], rules[j]);
+		if (!len || (*plen && len < *plen))
+			break;
+		if (!*plen)
+			*plen = len;
+	}
 
-	/* Disable RX Parser */
-	ret = dwxgmac3_rxp_disable(priv, ioaddr);
-	if (ret)
-		goto re_enable;
+	return j;
+}
+
+/**
+ * dwxgmac3_rxp_build - compile the parser program
+ * @priv: driver private structure
+ * @entries: tc entries
+ * @count: number of tc entries
+ * @base: table position of the first entry
+ * Description: rules keep their prio and insertion order, only runs of
+ * rules of the same prio and action are sorted by matches. Runs of rules
+ * sharing leading fragments and the action are then merged so the prefix
+ * takes its entries only once. The all pass entry goes last. The program
+ * is sized first, the entries and priv->rxp_next are only updated once it
+ * is known to fit.
+ * Return: number of entries laid out, 0 when there is no rule, or a
+ * negative error code when the program does not fit the table.
+ */
+static int dwxgmac3_rxp_build(struct tc956xmac_priv *priv,
+			      struct tc956xmac_tc_entry *entries,
+			      unsigned int count, unsigned int base)
+{
+	struct tc956xmac_tc_entry **rules = priv->rxp_order;
+	struct tc956xmac_tc_entry *entry;
+	unsigned int i, j, k, n = 0, nve = 0, size = 0, plen;
+	int ret;
+
+	BUILD_BUG_ON(sizeof(entry->val) !=
+		     sizeof(struct tc956xmac_rx_parser_entry));
 
-	/* Set all entries as NOT in HW */
 	for (i = 0; i < count; i++) {
 		entry = &entries[i];
-		entry->in_hw = false;
+		if (entry->in_use && !entry->is_last && !entry->is_frag)
+			rules[n++] = entry;
 	}
 
-	/* Update entries by reverse order */
-	while (1) {
-		entry = dwxgmac3_rxp_get_next_entry(entries, count, curr_prio);
-		if (!entry)
-			break;
+	if (!n) {
+		for (i = 0; i < count; i++)
+			entries[i].in_hw = false;
+		return 0;
+	}
 
-		curr_prio = entry->prio;
-		frag = entry->frag_ptr;
+	sort(rules, n, sizeof(*rules), dwxgmac3_rxp_cmp_rules, NULL);
 
-		/* Set special fragment requirements */
-		if (frag) {
-			entry->val.af = 0;
-			entry->val.rf = 0;
-			entry->val.nc = 1;
-			entry->val.ok_index = nve + 2;
+	for (i = 0; i < n; i = j) {
+		for (j = i + 1; j < n; j++) {
+			if (rules[j]->prio != rules[i]->prio ||
+			    !dwxgmac3_rxp_same_action(rules[i], rules[j]))
+				break;
 		}
 
-		ret = dwxgmac3_rxp_update_single_entry(priv, ioaddr, entry, nve);
-		if (ret)
-			goto re_enable;
+		if (j - i > 1)
+			sort(&rules[i], j - i, sizeof(*rules),
+			     dwxgmac3_rxp_cmp_chains, NULL);
+	}
 
-		entry->table_pos = nve++;
-		entry->in_hw = true;
+	/* Rules are admitted by TC956XMAC_RXP_SW_RATIO, the program may still
+	 * not fit: size it before anything is laid out.
+	 */
+	for (i = 0; i < n; i = j) {
+		j = dwxgmac3_rxp_group_end(rules, i, n, &plen);
+		size += plen;
+		for (k = i; k < j; k++)
+			size += dwxgmac3_rxp_chain_len(rules[k]) - plen;
+	}
 
-		if (frag && !frag->in_hw) {
-			ret = dwxgmac3_rxp_update_single_entry(priv, ioaddr, frag, nve);
-			if (ret)
-				goto re_enable;
-			frag->table_pos = nve++;
-			frag->in_hw = true;
-		}
+	for (i = 0; i < count; i++) {
+		if (entries[i].is_last)
+			size++;
 	}
 
-	if (!nve)
-		goto re_enable;
+	if (size > priv->rxp_hw_size)
+		return -ENOSPC;
+
+	for (i = 0; i < count; i++)
+		entries[i].in_hw = false;
+
+	for (i = 0; i < n; i = j) {
+		j = dwxgmac3_rxp_group_end(rules, i, n, &plen);
+
+		ret = dwxgmac3_rxp_emit_group(priv, &rules[i], j - i, plen,
+					      base, &nve);
+		if (ret)
+			return ret;
+	}
 
 	/* Update all pass entry */
 	for (i = 0; i < count; i++) {
@@ -1928,17 +2158,142 @@ static int dwxgmac3_rxp_config(struct tc956xmac_priv *priv, void __iomem *ioaddr
 		if (!entry->is_last)
 			continue;
 
-		ret = dwxgmac3_rxp_update_single_entry(priv, ioaddr, entry, nve);
-		if (ret)
-			goto re_enable;
+		memcpy(&priv->rxp_next[nve], &entry->val, sizeof(entry->val));
+		entry->table_pos = base + nve++;
+	}
+
+	return nve;
+}
+
+/* True when the staged program only differs from the one at @base in the
+ * actions it takes, which can then be patched in place.
+ */
+static bool dwxgmac3_rxp_same_matches(struct tc956xmac_priv *priv,
+				      unsigned int base, unsigned int nve)
+{
+	struct tc956xmac_rx_parser_entry *old, *new;
+	unsigned int i;
+
+	for (i = 0; i < nve; i++) {
+		old = &priv->rxp_hw[base + i];
+		new = &priv->rxp_next[i];
 
-		entry->table_pos = nve++;
+		if (old->match_data != new->match_data ||
+		    old->match_en != new->match_en ||
+		    old->frame_offset != new->frame_offset ||
+		    old->im != new->im || old->nc != new->nc ||
+		    old->ok_index != new->ok_index)
+			return false;
 	}
 
-	/* Assume n. of parsable entries == n. of valid entries */
-	val = (nve << 16) & XGMAC_NPE;
-	val |= nve & XGMAC_NVE;
+	return true;
+}
+
+static void dwxgmac3_rxp_set_nve(void __iomem *ioaddr, unsigned int nve)
+{
+	u32 val;
+
+	val = ((nve - 1) << 16) & XGMAC_NPE;
+	val |= (nve - 1) & XGMAC_NVE;
 	writel(val, ioaddr + XGMAC_MTL_RXP_CONTROL_STATUS);
+}
+
+/**
+ * dwxgmac3_rxp_config - program the RX parser from the tc entries
+ * @priv: driver private structure
+ * @ioaddr: MAC base address
+ * @entries: tc entries
+ * @count: number of tc entries
+ * Description: changes are applied without stopping the parser whenever
+ * possible:
+ * - a program that only changes actions is patched in place;
+ * - when the program fits in half the table, entry 0 jumps to one of two
+ *   banks, the new program is staged in the idle bank and the jump is
+ *   rewritten to switch over in a single write.
+ * Otherwise, and the first time, the table is rewritten with the parser
+ * and RX stopped.
+ */
+static int dwxgmac3_rxp_config(struct tc956xmac_priv *priv, void __iomem *ioaddr,
+			       struct tc956xmac_tc_entry *entries,
+			       unsigned int count)
+{
+	struct tc956xmac_rx_parser_entry jump = { };
+	unsigned int bank = (priv->rxp_hw_size - 1) / 2;
+	unsigned int base = priv->rxp_hw_base;
+	u32 old_val, val;
+	int nve, ret;
+
+	nve = dwxgmac3_rxp_build(priv, entries, count, base);
+	if (nve < 0)
+		return nve;
+
+	if (nve && priv->rxp_hw_valid) {
+		if (nve == priv->rxp_hw_nve &&
+		    dwxgmac3_rxp_same_matches(priv, base, nve))
+			return dwxgmac3_rxp_sync(priv, ioaddr, base, nve);
+
+		if (base && nve <= bank) {
+			base = (base == 1) ? 1 + bank : 1;
+			dwxgmac3_rxp_build(priv, entries, count, base);
+
+			ret = dwxgmac3_rxp_sync(priv, ioaddr, base, nve);
+			if (ret)
+				return ret;
+
+			/* An NC entry that never matches goes to ok_index */
+			jump.im = 1;
+			jump.nc = 1;
+			jump.ok_index = base;
+			ret = dwxgmac3_rxp_sync_entry(priv, ioaddr, &jump, 0);
+			if (ret)
+				return ret;
+
+			priv->rxp_hw_base = base;
+			priv->rxp_hw_nve = nve;
+			return 0;
+		}
+	}
+
+	/* Full rewrite, set up the banks if the program fits */
+	base = (nve && nve <= bank) ? 1 : 0;
+	if (nve)
+		nve = dwxgmac3_rxp_build(priv, entries, count, base);
+
+	/* Force disable RX */
+	old_val = readl(ioaddr + XGMAC_RX_CONFIG);
+	val = old_val & ~XGMAC_CONFIG_RE;
+	writel(val, ioaddr + XGMAC_RX_CONFIG);
+
+	/* Disable RX Parser */
+	ret = dwxgmac3_rxp_disable(priv, ioaddr);
+	if (ret)
+		goto re_enable;
+
+	/* Nothing is known of the table, have every word written */
+	memset(priv->rxp_hw, 0xff, priv->rxp_hw_size * sizeof(*priv->rxp_hw));
+	priv->rxp_hw_valid = false;
+
+	if (!nve)
+		goto re_enable;
+
+	if (base) {
+		jump.im = 1;
+		jump.nc = 1;
+		jump.ok_index = base;
+		ret = dwxgmac3_rxp_sync_entry(priv, ioaddr, &jump, 0);
+		if (ret)
+			goto re_enable;
+	}
+
+	ret = dwxgmac3_rxp_sync(priv, ioaddr, base, nve);
+	if (ret)
+		goto re_enable;
+
+	dwxgmac3_rxp_set_nve(ioaddr, base ? 1 + 2 * bank : nve);
+
+	priv->rxp_hw_base = base;
+	priv->rxp_hw_nve = nve;
+	priv->rxp_hw_valid = true;
 
 	/* Enable RX Parser */
 	dwxgmac3_rxp_enable(priv, ioaddr);
@@ -436,7 +436,7 @@ static int dwxgmac2_dma_interrupt(struct tc956xmac_priv *priv, void __iomem *ioa
 	if (unlikely(intr_status & XGMAC_AIS)) {
 		if (unlikely(intr_status & XGMAC_RBU)) {
 			x->rx_buf_unav_irq[chan]++;
-			ret |= handle_rx;
+			ret |= handle_rx | rx_buf_unav;
 		}
 		if (unlikely(intr_status & XGMAC_TPS)) {
 			x->tx_process_stopped_irq[chan]++;
@@ -444,7 +444,7 @@ static int dwxgmac2_dma_interrupt(struct tc956xmac_priv *priv, void __iomem *ioa
 		}
 		if (unlikely(intr_status & XGMAC_FBE)) {
 			x->fatal_bus_error_irq[chan]++;
-			ret |= tx_hard_error;
+			ret |= dma_fatal_error;
 		}
 	}
 
@@ -591,6 +591,12 @@ static void dwxgmac2_rx_watchdog(struct tc956xmac_priv *priv,
 	}
 }
 
+static void dwxgmac2_set_rx_watchdog(struct tc956xmac_priv *priv,
+					void __iomem *ioaddr, u32 riwt, u32 chan)
+{
+	writel(riwt & XGMAC_RWT, ioaddr + XGMAC_DMA_CH_Rx_WATCHDOG(chan));
+}
+
 static void dwxgmac2_set_rx_ring_len(struct tc956xmac_priv *priv,
 					void __iomem *ioaddr, u32 len, u32 chan)
 {
@@ -793,6 +799,7 @@ const struct tc956xmac_dma_ops dwxgmac210_dma_ops = {
 	.dma_interrupt = dwxgmac2_dma_interrupt,
 	.get_hw_feature = dwxgmac2_get_hw_feature,
 	.rx_watchdog = dwxgmac2_rx_watchdog,
+	.set_rx_watchdog = dwxgmac2_set_rx_watchdog,
 	.set_rx_ring_len = dwxgmac2_set_rx_ring_len,
 	.set_tx_ring_len = dwxgmac2_set_tx_ring_len,
 	.set_rx_tail_ptr = dwxgmac2_set_rx_tail_ptr,
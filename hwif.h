@@ -242,6 +242,7 @@ struct tc956xmac_dma_ops {
 			       struct dma_features *dma_cap);
 	/* Program the HW RX Watchdog */
 	void (*rx_watchdog)(struct tc956xmac_priv *priv, void __iomem *ioaddr, u32 riwt, u32 number_chan);
+	void (*set_rx_watchdog)(struct tc956xmac_priv *priv, void __iomem *ioaddr, u32 riwt, u32 chan);
 	void (*set_tx_ring_len)(struct tc956xmac_priv *priv, void __iomem *ioaddr, u32 len, u32 chan);
 	void (*set_rx_ring_len)(struct tc956xmac_priv *priv, void __iomem *ioaddr, u32 len, u32 chan);
 	void (*set_rx_tail_ptr)(struct tc956xmac_priv *priv, void __iomem *ioaddr, u32 tail_ptr, u32 chan);
@@ -294,6 +295,8 @@ struct tc956xmac_dma_ops {
 	tc956xmac_do_void_callback(__priv, dma, get_hw_feature, __args)
 #define tc956xmac_rx_watchdog(__priv, __args...) \
 	tc956xmac_do_void_callback(__priv, dma, rx_watchdog, __args)
+#define tc956xmac_set_rx_watchdog(__priv, __args...) \
+	tc956xmac_do_void_callback(__priv, dma, set_rx_watchdog, __args)
 #define tc956xmac_set_tx_ring_len(__priv, __args...) \
 	tc956xmac_do_void_callback(__priv, dma, set_tx_ring_len, __args)
 #define tc956xmac_set_rx_ring_len(__priv, __args...) \
@@ -600,6 +603,7 @@ struct tc_cbs_qopt_offload;
 struct flow_cls_offload;
 struct tc_taprio_qopt_offload;
 struct tc_etf_qopt_offload;
+struct ethtool_rxnfc;
 
 struct tc956xmac_tc_ops {
 	int (*init)(struct tc956xmac_priv *priv, void *data);
@@ -613,6 +617,8 @@ struct tc956xmac_tc_ops {
 			    struct tc_taprio_qopt_offload *qopt);
 	int (*setup_etf)(struct tc956xmac_priv *priv,
 			 struct tc_etf_qopt_offload *qopt);
+	int (*setup_rxnfc)(struct tc956xmac_priv *priv,
+			   struct ethtool_rxnfc *cmd);
 };
 
 #define tc956xmac_tc_init(__priv, __args...) \
@@ -627,6 +633,8 @@ struct tc956xmac_tc_ops {
 	tc956xmac_do_callback(__priv, tc, setup_taprio, __args)
 #define tc956xmac_tc_setup_etf(__priv, __args...) \
 	tc956xmac_do_callback(__priv, tc, setup_etf, __args)
+#define tc956xmac_tc_setup_rxnfc(__priv, __args...) \
+	tc956xmac_do_callback(__priv, tc, setup_rxnfc, __args)
 
 struct tc956xmac_counters;
 
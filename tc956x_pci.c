@@ -36,6 +36,7 @@
 #include <linux/pci.h>
 #include <linux/dmi.h>
 #include <linux/firmware.h>
+#include <linux/crc32.h>
 #include <linux/version.h>
 #include <linux/aer.h>
 #include <linux/iopoll.h>
@@ -57,6 +58,8 @@
 static unsigned int tc956x_speed = 3;
 #endif
 
+static unsigned int tc956x_msi_multi_vec;
+
 
 static const struct tc956x_version tc956x_drv_version = {0, 1, 0, 0};
 
@@ -691,7 +694,7 @@ static void xgmac_default_data(struct plat_tc956xmacenet_data *plat)
 	}
 
 	plat->riwt_off = 0;
-	plat->rss_en = 0;
+	plat->rss_en = 1;
 #endif
 
 	/*For RXP config */
@@ -1166,11 +1169,63 @@ static const struct tc956xmac_pci_info tc956xmac_xgmac3_2_5g_mdio_pci_info = {
 };
 #endif /* TC956X_UNSUPPORTED_UNTESTED_FEATURE */
 
+/*!
+ * \brief API to check whether the CM3 already runs a firmware image.
+ *
+ * \details On warm starts (resume from D3hot) the SRAM still holds the
+ * image this driver loaded last time. That image has to be the one about to
+ * be loaded, the CM3 has to be out of reset, report its init sync and still
+ * publish the version it did after the download. Its systick count has to
+ * advance as well, as for the firmware health check.
+ *
+ * \param[in] dev    - pointer to device structure.
+ * \param[in] res    - pointer to tc956xmac_resources structure.
+ * \param[in] fw_crc - CRC32 of the image to be loaded.
+ *
+ * \return true when the download can be skipped.
+ */
+static bool tc956x_fw_running(struct device *dev,
+			      struct tc956xmac_resources *res, u32 fw_crc)
+{
+#ifdef TC956X
+	void __iomem *sram = res->tc956x_SRAM_pci_base_addr;
+	u32 fw_ver, systick;
+
+	/* No image loaded by this driver yet, or a different one */
+	if (!res->fw_ver || res->fw_crc != fw_crc)
+		return false;
+
+	if (ioread32((void __iomem *)(res->addr + NRSTCTRL0_OFFSET)) &
+	    NRSTCTRL0_RST_ASRT)
+		return false;
+
+	if (!ioread32(sram + TC956X_M3_INIT_DONE) ||
+	    ioread32(sram + TC956X_M3_FW_EXIT))
+		return false;
+
+	fw_ver = ioread32(sram + TC956X_M3_DBG_VER_START);
+	if (fw_ver != res->fw_ver)
+		return false;
+
+	systick = ioread32(sram + SYSTCIK_SRAM_OFFSET);
+	mdelay(1);
+	if (ioread32(sram + SYSTCIK_SRAM_OFFSET) == systick)
+		return false;
+
+	NMSGPR_INFO(dev, "FW version 0x%08x already running\n", fw_ver);
+
+	return true;
+#else
+	return false;
+#endif
+}
+
 /*!
  * \brief API to load firmware for CM3.
  *
  * \details This fucntion loads the firmware onto the SRAM of tc956x.
  * The tc956x CM3 starts executing once the firmware loading is complete.
+ * The download is skipped when the same image is already running.
  *
  * \param[in] dev  - pointer to device structure.
  * \param[in] id   - pointer to tc956xmac_resources structure.
@@ -1184,53 +1239,15 @@ s32 tc956x_load_firmware(struct device *dev, struct tc956xmac_resources *res)
 {
 	u32 adrs = 0, val = 0;
 	u32 fw_init_sync;
+	const u8 *fw_image;
+	size_t fw_size;
+	u32 fw_crc;
+	s32 ret = 0;
 #ifdef TC956X_LOAD_FW_HEADER
-	u32 fw_size = sizeof(fw_data);
-
 	NMSGPR_INFO(dev,  "FW Loading: .h\n");
-	/* Validate the size of the firmware */
-	if (fw_size > TC956X_FW_MAX_SIZE) {
-		NMSGPR_ERR(dev, "Error : FW size exceeds the memory size\n");
-		return -EINVAL;
-	}
-
-	NMSGPR_INFO(dev,  "FW Loading Start...\n");
-	NMSGPR_INFO(dev,  "FW Size = %d\n", fw_size);
-
-#ifdef TC956X
-	/* Assert M3 reset */
-	adrs = NRSTCTRL0_OFFSET;
-#else
-	adrs = NRSTCTRL_OFFSET;
-#endif
-	val = ioread32((void __iomem *)(res->addr + adrs));
-	NMSGPR_INFO(dev,  "Reset Register value = %lx\n", (unsigned long)val);
-
-	val |= NRSTCTRL0_RST_ASRT;
-	iowrite32(val, (void __iomem *)(res->addr + adrs));
-
-#ifdef TC956X
-	iowrite32(0, (void __iomem *)(res->tc956x_SRAM_pci_base_addr +
-			TC956X_M3_INIT_DONE));
-	iowrite32(0, (void __iomem *)(res->tc956x_SRAM_pci_base_addr +
-			TC956X_M3_FW_EXIT));
-#endif
-	/* Copy TC956X FW to SRAM */
-	adrs = TC956X_ZERO;/* SRAM Start Address */
-	do {
-		val =  fw_data[adrs + TC956X_ZERO] << TC956X_ZERO;
-		val |= fw_data[adrs + TC956X_ONE] << TC956X_EIGHT;
-		val |= fw_data[adrs + TC956X_TWO] << TC956X_SIXTEEN;
-		val |= fw_data[adrs + TC956X_THREE] << TC956X_TWENTY_FOUR;
-
-#ifdef TC956X
-		iowrite32(val, (void __iomem *)(res->tc956x_SRAM_pci_base_addr +
-			adrs));
-#endif
-
-		adrs += TC956X_FOUR;
-	} while (adrs < fw_size);
 
+	fw_image = fw_data;
+	fw_size = sizeof(fw_data);
 #else
 	const struct firmware *pfw = NULL;
 
@@ -1248,14 +1265,28 @@ s32 tc956x_load_firmware(struct device *dev, struct tc956xmac_resources *res)
 		return -EINVAL;
 	}
 
+	fw_image = pfw->data;
+	fw_size = pfw->size;
+#endif
+
 	/* Validate the size of the firmware */
-	if (pfw->size > TC956X_FW_MAX_SIZE) {
+	if (fw_size > TC956X_FW_MAX_SIZE) {
 		NMSGPR_ERR(dev, "Error : FW size exceeds the memory size\n");
-		return -EINVAL;
+		ret = -EINVAL;
+		goto out;
+	}
+
+	fw_crc = crc32_le(~0, fw_image, fw_size);
+	if (tc956x_fw_running(dev, res, fw_crc)) {
+		NMSGPR_INFO(dev,  "FW Loading skipped.\n");
+		goto out;
 	}
 
+	res->fw_crc = 0;
+	res->fw_ver = 0;
+
 	NMSGPR_INFO(dev,  "FW Loading Start...\n");
-	NMSGPR_INFO(dev,  "FW Size = %ld\n", (long int)(pfw->size));
+	NMSGPR_INFO(dev,  "FW Size = %ld\n", (long int)fw_size);
 
 	/* Assert M3 reset */
 #ifdef TC956X
@@ -1272,14 +1303,13 @@ s32 tc956x_load_firmware(struct device *dev, struct tc956xmac_resources *res)
 #ifdef TC956X
 	iowrite32(0, (void __iomem *)(res->tc956x_SRAM_pci_base_addr +
 			TC956X_M3_INIT_DONE));
+#ifdef TC956X_LOAD_FW_HEADER
+	iowrite32(0, (void __iomem *)(res->tc956x_SRAM_pci_base_addr +
+			TC956X_M3_FW_EXIT));
 #endif
 
-#ifdef TC956X
 	/* Copy TC956X FW to SRAM */
-	memcpy_toio(res->tc956x_SRAM_pci_base_addr, pfw->data, pfw->size);
-#endif
-	/* Release kernel firmware interface */
-	release_firmware(pfw);
+	memcpy_toio(res->tc956x_SRAM_pci_base_addr, fw_image, fw_size);
 #endif
 
 	NMSGPR_INFO(dev,  "FW Loading Finish.\n");
@@ -1298,12 +1328,24 @@ s32 tc956x_load_firmware(struct device *dev, struct tc956xmac_resources *res)
 	readl_poll_timeout_atomic(res->tc956x_SRAM_pci_base_addr + TC956X_M3_INIT_DONE,
 				fw_init_sync, fw_init_sync, 100, 100000);
 #endif
-	if (!fw_init_sync)
+	if (!fw_init_sync) {
 		NMSGPR_ALERT(dev, "TC956x FW yet to start!!!");
-	else
+	} else {
 		NMSGPR_INFO(dev,  "TC956x M3 started.\n");
+#ifdef TC956X
+		/* Record the image for the next warm start */
+		res->fw_crc = fw_crc;
+		res->fw_ver = ioread32(res->tc956x_SRAM_pci_base_addr +
+				       TC956X_M3_DBG_VER_START);
+#endif
+	}
 
-	return 0;
+out:
+#ifndef TC956X_LOAD_FW_HEADER
+	/* Release kernel firmware interface */
+	release_firmware(pfw);
+#endif
+	return ret;
 }
 
 #ifdef DMA_OFFLOAD_ENABLE
@@ -1927,8 +1969,22 @@ static int tc956xmac_pci_probe(struct pci_dev *pdev,
 #endif
 
 	NMSGPR_INFO(&(pdev->dev), "Initialising eMAC Port %d\n", res.port_num);
-	/* Enable MSI Operation */
-	ret = pci_enable_msi(pdev);
+	/* Enable MSI Operation. In multi vector mode each DMA channel gets
+	 * its own vector, fall back to a single shared vector otherwise.
+	 */
+	ret = -ENOSPC;
+	if (tc956x_msi_multi_vec)
+		ret = pci_alloc_irq_vectors(pdev, TC956X_MSI_VECTOR_MAX,
+					    TC956X_MSI_VECTOR_MAX, PCI_IRQ_MSI);
+	if (ret == TC956X_MSI_VECTOR_MAX) {
+		res.msi_multi_vec = true;
+		ret = 0;
+	} else {
+		if (tc956x_msi_multi_vec)
+			NMSGPR_INFO(&(pdev->dev),
+				    "Multi vector MSI unavailable, using single vector\n");
+		ret = pci_enable_msi(pdev);
+	}
 	if (ret) {
 		dev_err(&(pdev->dev),
 		"%s:Enable MSI error\n", TC956X_RESOURCE_NAME);
@@ -2051,6 +2107,14 @@ static int tc956xmac_pci_probe(struct pci_dev *pdev,
 	res.irq = pdev->irq;
 	res.lpi_irq = pdev->irq;
 
+	if (res.msi_multi_vec) {
+		u32 chan;
+
+		for (chan = 0; chan < TC956XMAC_CH_MAX; chan++)
+			res.ch_irq[chan] = pci_irq_vector(pdev,
+						TC956X_MSI_CH_VECTOR(chan));
+	}
+
 	plat->bus_id = res.port_num;
 
 	ret = tc956xmac_dvr_probe(&pdev->dev, plat, &res);
@@ -2082,7 +2146,7 @@ static int tc956xmac_pci_probe(struct pci_dev *pdev,
 
 err_out_msi_failed:
 err_dvr_probe:
-	pci_disable_msi(pdev);
+	pci_free_irq_vectors(pdev);
 #ifdef DISABLE_EMAC_PORT1
 disable_emac_port:
 #endif
@@ -2129,7 +2193,7 @@ static void tc956xmac_pci_remove(struct pci_dev *pdev)
 	pdev->irq = 0;
 
 	/* Enable MSI Operation */
-	pci_disable_msi(pdev);
+	pci_free_irq_vectors(pdev);
 
 	if (priv->plat->tc956xmac_clk)
 		clk_unregister_fixed_rate(priv->plat->tc956xmac_clk);
@@ -2638,6 +2702,10 @@ MODULE_PARM_DESC(tc956x_speed,
 		 "PCIe speed Gen TC9563_64 - default is 3, [1..3]");
 #endif
 
+module_param(tc956x_msi_multi_vec, uint, 0444);
+MODULE_PARM_DESC(tc956x_msi_multi_vec,
+		 "Use a dedicated MSI vector per DMA channel - default is 0, [0..1]");
+
 MODULE_DESCRIPTION("TC956X PCI Express Ethernet Network Driver");
 MODULE_AUTHOR("Toshiba Electronic Devices & Storage Corporation");
 MODULE_LICENSE("GPL v2");
@@ -37,6 +37,7 @@
 
 
 #include <linux/clk.h>
+#include <linux/dim.h>
 #include <linux/if_vlan.h>
 #include "tc956xmac_inc.h"
 #include <linux/phylink.h>
@@ -45,7 +46,10 @@
 #include <linux/ptp_clock_kernel.h>
 #include <linux/net_tstamp.h>
 #include <linux/reset.h>
+#include <linux/u64_stats_sync.h>
 #include <net/page_pool.h>
+#include <net/xdp.h>
+#include <net/xdp_sock.h>
 #include <linux/version.h>
 
 //#define TC956X_LOAD_FW_HEADER
@@ -200,15 +204,53 @@ struct tc956xmac_resources {
 	int irq;
 #ifdef TC956X
 	unsigned int port_num;
+	bool msi_multi_vec;
+	int ch_irq[TC956XMAC_CH_MAX];
+	/* CRC of the image loaded last and the version it published */
+	u32 fw_crc;
+	u32 fw_ver;
 #endif
 };
 
+enum tc956xmac_txbuf_type {
+	TC956XMAC_TXBUF_T_SKB,
+	TC956XMAC_TXBUF_T_XDP_TX,
+	TC956XMAC_TXBUF_T_XDP_NDO,
+	TC956XMAC_TXBUF_T_XSK_TX,
+	TC956XMAC_TXBUF_T_BOUNCE,
+};
+
+/* Per descriptor slot of the pre-mapped TX bounce buffer */
+#define TC956XMAC_TX_BOUNCE_SZ	256
+
 struct tc956xmac_tx_info {
 	dma_addr_t buf;
 	bool map_as_page;
 	unsigned int len;
 	bool last_segment;
 	bool is_jumbo;
+	enum tc956xmac_txbuf_type buf_type;
+};
+
+/* Per queue counters, each queue is only updated by its own NAPI/xmit path.
+ * On TX the xmit path and tx_clean run concurrently, so each of them has
+ * its own sync point.
+ */
+struct tc956xmac_txq_stats {
+	u64 tx_bytes;
+	u64 tx_dropped;
+	struct u64_stats_sync syncp;
+	u64 tx_packets;
+	u64 tx_errors;
+	struct u64_stats_sync napi_syncp;
+};
+
+struct tc956xmac_rxq_stats {
+	u64 rx_packets;
+	u64 rx_bytes;
+	u64 rx_dropped;
+	u64 rx_errors;
+	struct u64_stats_sync syncp;
 };
 
 #define TC956XMAC_TBS_AVAIL	BIT(0)
@@ -218,6 +260,8 @@ struct tc956xmac_tx_info {
 /* Frequently used values are kept adjacent for cache effect */
 struct tc956xmac_tx_queue {
 	u32 tx_count_frames;
+	u32 tx_coal_frames;
+	u32 tx_coal_timer;
 	int tbs;
 	struct timer_list txtimer;
 	u32 queue_index;
@@ -226,12 +270,21 @@ struct tc956xmac_tx_queue {
 	struct dma_edesc *dma_entx;
 	struct dma_desc *dma_tx;
 	struct sk_buff **tx_skbuff;
+	struct xdp_frame **xdpf;
 	struct tc956xmac_tx_info *tx_skbuff_dma;
 	unsigned int cur_tx;
 	unsigned int dirty_tx;
+	/* Last entry handed to the DMA by the doorbell, tx_clean stops there */
+	unsigned int tail_tx;
 	dma_addr_t dma_tx_phy;
 	u32 tx_tail_addr;
 	u32 mss;
+	unsigned int dma_tx_size;
+	struct xdp_umem *xsk_umem;
+	/* Small frames are copied here, one slot per descriptor */
+	void *tx_bounce;
+	dma_addr_t tx_bounce_dma;
+	struct tc956xmac_txq_stats txq_stats ____cacheline_aligned_in_smp;
 #ifdef DMA_OFFLOAD_ENABLE
 	struct sk_buff **tx_offload_skbuff;
 	dma_addr_t *tx_offload_skbuff_dma;
@@ -243,10 +296,15 @@ struct tc956xmac_rx_buffer {
 	struct page *sec_page;
 	dma_addr_t addr;
 	dma_addr_t sec_addr;
+	/* AF_XDP zero-copy: UMEM chunk posted in place of the page */
+	void *xsk_data;
+	u64 xsk_handle;
 };
 
 struct tc956xmac_rx_queue {
 	u32 rx_count_frames;
+	u32 rx_coal_frames;
+	u32 rx_riwt;
 	u32 queue_index;
 	struct page_pool *page_pool;
 	struct tc956xmac_rx_buffer *buf_pool;
@@ -258,12 +316,20 @@ struct tc956xmac_rx_queue {
 	u32 rx_zeroc_thresh;
 	dma_addr_t dma_rx_phy;
 	u32 rx_tail_addr;
+	unsigned int dma_rx_size;
+	unsigned int dma_buf_sz;
 	unsigned int state_saved;
 	struct {
 		struct sk_buff *skb;
 		unsigned int len;
 		unsigned int error;
 	} state;
+	struct xdp_rxq_info xdp_rxq;
+	struct xdp_umem *xsk_umem;
+	/* Zero-copy slots holding a UMEM chunk and owned by the DMA */
+	unsigned int xsk_armed;
+	struct zero_copy_allocator zca;
+	struct tc956xmac_rxq_stats rxq_stats ____cacheline_aligned_in_smp;
 #ifdef DMA_OFFLOAD_ENABLE
 	struct sk_buff **rx_offload_skbuff;
 	dma_addr_t *rx_offload_skbuff_dma;
@@ -276,6 +342,15 @@ struct tc956xmac_channel {
 	struct tc956xmac_priv *priv_data;
 	spinlock_t lock;
 	u32 index;
+	int irq;
+	char irq_name[IFNAMSIZ + 8];
+	/* Adaptive interrupt moderation, sampled once per NAPI run */
+	struct dim rx_dim;
+	struct dim tx_dim;
+	u16 rx_dim_events;
+	u16 tx_dim_events;
+	/* RX buffer unavailable interrupts since the last received frame */
+	u16 rbu_events;
 };
 
 struct tc956xmac_tc_entry {
@@ -285,8 +360,13 @@ struct tc956xmac_tc_entry {
 	bool is_frag;
 	void *frag_ptr;
 	unsigned int table_pos;
+	/* HW entries of the rule alone, and of the prefix it shares */
+	unsigned int hw_entries;
+	unsigned int hw_shared;
 	u32 handle;
 	u32 prio;
+	/* Insertion order, keeps rules of the same prio in place */
+	u32 seq;
 	struct {
 		u32 match_data;
 		u32 match_en;
@@ -295,13 +375,39 @@ struct tc956xmac_tc_entry {
 		u8 im:1;
 		u8 nc:1;
 		u8 res1:4;
-		u8 frame_offset;
+		u8 frame_offset:6;
+		u8 res2:2;
 		u8 ok_index;
-		u8 dma_ch_no;
-		u32 res2;
+		u8 res3;
+		u16 dma_ch_no;
+		u16 res4;
 	} __packed val;
 };
 
+/* ethtool ntuple and tc flower rules share the parser table with the tc
+ * u32 knodes. u32 never hands out knodes in its root hash table, so that
+ * htid is used to tag the entries compiled from the other two.
+ */
+#define TC956XMAC_RX_NFC_MAX		32
+#define TC956XMAC_RX_NFC_HANDLE(loc)	(0xfff00000 | (loc))
+#define TC956XMAC_RXP_FLOW_MAX		256
+#define TC956XMAC_RXP_FLOW_HANDLE(idx)	(0xfff01000 | (idx))
+/* Rule fragments per RX parser entry, prefixes are shared in HW */
+#define TC956XMAC_RXP_SW_RATIO		4
+
+struct tc956xmac_rx_nfc_rule {
+	bool in_use;
+	unsigned int entries;
+	struct ethtool_rx_flow_spec fs;
+};
+
+struct tc956xmac_rxp_flow {
+	bool in_use;
+	bool steer;
+	unsigned int entries;
+	unsigned long cookie;
+};
+
 #ifdef TC956X
 #define TC956XMAC_PPS_MAX		3 /* Two are for output signal generation and one is internal use for eMAC */
 #else
@@ -342,16 +448,36 @@ struct tc956xmac_priv {
 	u32 tx_coal_frames;
 	u32 tx_coal_timer;
 	u32 rx_coal_frames;
+	bool rx_dim_enabled;
+	bool tx_dim_enabled;
 
 	int tx_coalesce;
 	int hwts_tx_en;
 	bool tx_path_in_lpi_mode;
 	bool tso;
 	int sph;
+	/* Split header with page sized payload buffers (ethtool priv flag) */
+	bool rx_page_split;
 	u32 sarc_type;
 
 	unsigned int dma_buf_sz;
+	u32 dma_tx_size;
+	u32 dma_rx_size;
 	unsigned int rx_copybreak;
+	unsigned int tx_copybreak;
+	bool rx_build_skb;
+	struct bpf_prog *xdp_prog;
+	/* Queues bound to an AF_XDP zero-copy socket */
+	unsigned long af_xdp_zc_qps;
+	/* TX queues sharing the best-effort traffic */
+	u8 tx_be_queue[MTL_MAX_TX_QUEUES];
+	u32 tx_be_queue_cnt;
+	u32 tx_be_mask;
+	/* MTL queues of the platform configuration */
+	u32 mtl_rx_queues;
+	u32 mtl_tx_queues;
+	/* Per host TX queue FIFO once ethtool -L added MTL queues, 0 otherwise */
+	u32 tx_fifo_split;
 	u32 rx_riwt;
 	int hwts_rx_en;
 
@@ -412,6 +538,7 @@ struct tc956xmac_priv {
 	int clk_csr;
 	struct timer_list eee_ctrl_timer;
 	int lpi_irq;
+	bool msi_multi_vec;
 	int eee_enabled;
 	int eee_active;
 	int tx_lpi_timer;
@@ -443,6 +570,12 @@ struct tc956xmac_priv {
 	unsigned long state;
 	struct workqueue_struct *wq;
 	struct work_struct service_task;
+	/* Rings and page pools kept allocated across suspend */
+	bool pm_fast_resume;
+	/* Channels waiting for a DMA restart after a fault */
+	struct work_struct chan_reset_task;
+	unsigned long tx_reset_mask;
+	unsigned long rx_reset_mask;
 
 	/* CBS configurations */
 	struct tc956x_cbs_params cbs_speed100_cfg[8];
@@ -454,6 +587,18 @@ struct tc956xmac_priv {
 	unsigned int tc_entries_max;
 	unsigned int tc_off_max;
 	struct tc956xmac_tc_entry *tc_entries;
+	struct tc956xmac_rx_nfc_rule rx_nfc[TC956XMAC_RX_NFC_MAX];
+	unsigned int rx_nfc_count;
+	struct tc956xmac_rxp_flow rxp_flows[TC956XMAC_RXP_FLOW_MAX];
+	/* RX parser table as last written to the HW, and the next one */
+	struct tc956xmac_rx_parser_entry *rxp_hw;
+	struct tc956xmac_rx_parser_entry *rxp_next;
+	struct tc956xmac_tc_entry **rxp_order;
+	u32 rxp_seq;
+	unsigned int rxp_hw_size;
+	unsigned int rxp_hw_base;
+	unsigned int rxp_hw_nve;
+	bool rxp_hw_valid;
 	unsigned int flow_entries_max;
 	struct tc956xmac_flow_entry *flow_entries;
 
@@ -475,6 +620,9 @@ struct tc956xmac_priv {
 	u32 port_num;
 	u32 mac_loopback_mode;
 	u32 phy_loopback_mode;
+	/* CM3 image loaded last, see tc956x_load_firmware() */
+	u32 fw_crc;
+	u32 fw_ver;
 #endif
 
 	/* set to 1 when ptp offload is enabled, else 0. */
@@ -556,6 +704,10 @@ int tc956xmac_dvr_probe(struct device *device,
 		     struct plat_tc956xmacenet_data *plat_dat,
 		     struct tc956xmac_resources *res);
 void tc956xmac_disable_eee_mode(struct tc956xmac_priv *priv);
+int tc956xmac_reinit_ringparam(struct net_device *dev, u32 rx_size, u32 tx_size);
+int tc956xmac_reinit_rx_page_split(struct net_device *dev, bool enable);
+int tc956xmac_reinit_queues(struct net_device *dev, u32 rx_cnt, u32 tx_cnt);
+u32 tc956xmac_usec2riwt(u32 usec, struct tc956xmac_priv *priv);
 bool tc956xmac_eee_init(struct tc956xmac_priv *priv);
 
 #ifdef CONFIG_TC956XMAC_SELFTESTS
@@ -584,6 +736,69 @@ static inline int tc956xmac_selftest_get_count(struct tc956xmac_priv *priv)
 
 s32 tc956x_load_firmware(struct device *dev, struct tc956xmac_resources *res);
 
+/* XDP verdicts reported by the RX path */
+#define TC956XMAC_XDP_PASS		0
+#define TC956XMAC_XDP_CONSUMED		BIT(0)
+#define TC956XMAC_XDP_TX		BIT(1)
+#define TC956XMAC_XDP_REDIRECT		BIT(2)
+
+static inline bool tc956xmac_xdp_is_enabled(struct tc956xmac_priv *priv)
+{
+	return !!priv->xdp_prog;
+}
+
+/* UMEM of the AF_XDP socket bound to @queue, NULL if not in zero-copy mode */
+static inline struct xdp_umem *tc956xmac_xsk_umem(struct tc956xmac_priv *priv,
+						  u32 queue)
+{
+	if (!tc956xmac_xdp_is_enabled(priv) ||
+	    !test_bit(queue, &priv->af_xdp_zc_qps))
+		return NULL;
+
+	return xdp_get_umem_from_qid(priv->dev, queue);
+}
+
+/* Headroom reserved in front of every RX buffer */
+static inline unsigned int tc956xmac_rx_offset(struct tc956xmac_priv *priv)
+{
+	if (tc956xmac_xdp_is_enabled(priv))
+		return XDP_PACKET_HEADROOM;
+	if (priv->rx_build_skb)
+		return NET_SKB_PAD;
+
+	return 0;
+}
+
+/* Size of one RX page_pool allocation */
+static inline unsigned int tc956xmac_rx_page_order(struct tc956xmac_priv *priv)
+{
+	return ilog2(DIV_ROUND_UP(priv->dma_buf_sz, PAGE_SIZE));
+}
+
+/* XDP_TX transmits straight from the RX pages, so map them both ways */
+static inline enum dma_data_direction
+tc956xmac_rx_dma_dir(struct tc956xmac_priv *priv)
+{
+	if (tc956xmac_xdp_is_enabled(priv))
+		return DMA_BIDIRECTIONAL;
+
+	return DMA_FROM_DEVICE;
+}
+
 int tc956x_set_pci_speed(struct pci_dev *pdev, u32 speed);
+int tc956xmac_rx_parser_configuration(struct tc956xmac_priv *priv);
+
+/* True when tc or ethtool ntuple rules own the RX parser table */
+static inline bool tc956xmac_rxp_has_rules(struct tc956xmac_priv *priv)
+{
+	unsigned int i;
+
+	for (i = 0; i < priv->tc_entries_max; i++) {
+		if (priv->tc_entries[i].in_use && !priv->tc_entries[i].is_last)
+			return true;
+	}
+
+	return false;
+}
 
 #endif /* __TC956XMAC_H__ */
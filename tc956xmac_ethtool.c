@@ -393,6 +393,40 @@ static const struct tc956xmac_stats tc956xmac_gstrings_stats[] = {
 	TC956XMAC_STAT(tx_tso_nfrags[6]),
 	TC956XMAC_STAT(tx_tso_nfrags[7]),
 
+	/* XDP */
+	TC956XMAC_STAT(rx_xdp_drop[0]),
+	TC956XMAC_STAT(rx_xdp_drop[1]),
+	TC956XMAC_STAT(rx_xdp_drop[2]),
+	TC956XMAC_STAT(rx_xdp_drop[3]),
+	TC956XMAC_STAT(rx_xdp_drop[4]),
+	TC956XMAC_STAT(rx_xdp_drop[5]),
+	TC956XMAC_STAT(rx_xdp_drop[6]),
+	TC956XMAC_STAT(rx_xdp_drop[7]),
+	TC956XMAC_STAT(rx_xdp_tx[0]),
+	TC956XMAC_STAT(rx_xdp_tx[1]),
+	TC956XMAC_STAT(rx_xdp_tx[2]),
+	TC956XMAC_STAT(rx_xdp_tx[3]),
+	TC956XMAC_STAT(rx_xdp_tx[4]),
+	TC956XMAC_STAT(rx_xdp_tx[5]),
+	TC956XMAC_STAT(rx_xdp_tx[6]),
+	TC956XMAC_STAT(rx_xdp_tx[7]),
+	TC956XMAC_STAT(rx_xdp_redirect[0]),
+	TC956XMAC_STAT(rx_xdp_redirect[1]),
+	TC956XMAC_STAT(rx_xdp_redirect[2]),
+	TC956XMAC_STAT(rx_xdp_redirect[3]),
+	TC956XMAC_STAT(rx_xdp_redirect[4]),
+	TC956XMAC_STAT(rx_xdp_redirect[5]),
+	TC956XMAC_STAT(rx_xdp_redirect[6]),
+	TC956XMAC_STAT(rx_xdp_redirect[7]),
+	TC956XMAC_STAT(tx_xdp_xmit[0]),
+	TC956XMAC_STAT(tx_xdp_xmit[1]),
+	TC956XMAC_STAT(tx_xdp_xmit[2]),
+	TC956XMAC_STAT(tx_xdp_xmit[3]),
+	TC956XMAC_STAT(tx_xdp_xmit[4]),
+	TC956XMAC_STAT(tx_xdp_xmit[5]),
+	TC956XMAC_STAT(tx_xdp_xmit[6]),
+	TC956XMAC_STAT(tx_xdp_xmit[7]),
+
 	/* Tx Desc statistics */
 	TC956XMAC_STAT(txch_status[0]),
 	TC956XMAC_STAT(txch_status[1]),
@@ -686,9 +720,20 @@ static const struct tc956xmac_stats tc956xmac_mmc[] = {
 };
 #define TC956XMAC_MMC_STATS_LEN ARRAY_SIZE(tc956xmac_mmc)
 
+/* Per queue counters, same layout for rx_q%u_ and tx_q%u_ */
+static const char tc956xmac_qstats_string[][ETH_GSTRING_LEN] = {
+	"packets",
+	"bytes",
+	"dropped",
+	"errors",
+};
+#define TC956XMAC_QSTATS_LEN ARRAY_SIZE(tc956xmac_qstats_string)
+
 static const char tc956x_priv_flags_strings[][ETH_GSTRING_LEN] = {
 #define TC956XMAC_TX_FCS	BIT(0)
 "tx-fcs",
+#define TC956XMAC_RX_PAGE_SPLIT	BIT(1)
+"rx-page-split",
 };
 
 #define TC956X_PRIV_FLAGS_STR_LEN ARRAY_SIZE(tc956x_priv_flags_strings)
@@ -914,6 +959,33 @@ static int tc956xmac_nway_reset(struct net_device *dev)
 }
 #endif
 
+static void tc956xmac_get_ringparam(struct net_device *netdev,
+				    struct ethtool_ringparam *ring)
+{
+	struct tc956xmac_priv *priv = netdev_priv(netdev);
+
+	ring->rx_max_pending = DMA_MAX_RX_SIZE;
+	ring->tx_max_pending = DMA_MAX_TX_SIZE;
+	ring->rx_pending = priv->dma_rx_size;
+	ring->tx_pending = priv->dma_tx_size;
+}
+
+static int tc956xmac_set_ringparam(struct net_device *netdev,
+				   struct ethtool_ringparam *ring)
+{
+	if (ring->rx_mini_pending || ring->rx_jumbo_pending ||
+	    ring->rx_pending < DMA_MIN_RX_SIZE ||
+	    ring->rx_pending > DMA_MAX_RX_SIZE ||
+	    !is_power_of_2(ring->rx_pending) ||
+	    ring->tx_pending < DMA_MIN_TX_SIZE ||
+	    ring->tx_pending > DMA_MAX_TX_SIZE ||
+	    !is_power_of_2(ring->tx_pending))
+		return -EINVAL;
+
+	return tc956xmac_reinit_ringparam(netdev, ring->rx_pending,
+					  ring->tx_pending);
+}
+
 static void
 tc956xmac_get_pauseparam(struct net_device *netdev,
 		      struct ethtool_pauseparam *pause)
@@ -1020,6 +1092,41 @@ static void tc956xmac_get_ethtool_stats(struct net_device *dev,
 		data[j++] = (tc956xmac_gstrings_stats[i].sizeof_stat ==
 			     sizeof(u64)) ? (*(u64 *)p) : (*(u32 *)p);
 	}
+
+	for (i = 0; i < rx_queues_count; i++) {
+		struct tc956xmac_rxq_stats *rxq_stats =
+			&priv->rx_queue[i].rxq_stats;
+		unsigned int start;
+
+		do {
+			start = u64_stats_fetch_begin_irq(&rxq_stats->syncp);
+			data[j] = rxq_stats->rx_packets;
+			data[j + 1] = rxq_stats->rx_bytes;
+			data[j + 2] = rxq_stats->rx_dropped;
+			data[j + 3] = rxq_stats->rx_errors;
+		} while (u64_stats_fetch_retry_irq(&rxq_stats->syncp, start));
+		j += TC956XMAC_QSTATS_LEN;
+	}
+
+	for (i = 0; i < tx_queues_count; i++) {
+		struct tc956xmac_txq_stats *txq_stats =
+			&priv->tx_queue[i].txq_stats;
+		unsigned int start;
+
+		do {
+			start = u64_stats_fetch_begin_irq(&txq_stats->syncp);
+			data[j + 1] = txq_stats->tx_bytes;
+			data[j + 2] = txq_stats->tx_dropped;
+		} while (u64_stats_fetch_retry_irq(&txq_stats->syncp, start));
+
+		do {
+			start = u64_stats_fetch_begin_irq(&txq_stats->napi_syncp);
+			data[j] = txq_stats->tx_packets;
+			data[j + 3] = txq_stats->tx_errors;
+		} while (u64_stats_fetch_retry_irq(&txq_stats->napi_syncp,
+						   start));
+		j += TC956XMAC_QSTATS_LEN;
+	}
 }
 
 static int tc956xmac_get_sset_count(struct net_device *netdev, int sset)
@@ -1030,6 +1137,8 @@ static int tc956xmac_get_sset_count(struct net_device *netdev, int sset)
 	switch (sset) {
 	case ETH_SS_STATS:
 		len = TC956XMAC_STATS_LEN;
+		len += (priv->plat->rx_queues_to_use +
+			priv->plat->tx_queues_to_use) * TC956XMAC_QSTATS_LEN;
 
 		if (priv->dma_cap.rmon)
 			len += TC956XMAC_MMC_STATS_LEN;
@@ -1057,7 +1166,7 @@ static int tc956xmac_get_sset_count(struct net_device *netdev, int sset)
 
 static void tc956xmac_get_strings(struct net_device *dev, u32 stringset, u8 *data)
 {
-	int i;
+	int i, q;
 	u8 *p = data;
 	struct tc956xmac_priv *priv = netdev_priv(dev);
 
@@ -1086,6 +1195,20 @@ static void tc956xmac_get_strings(struct net_device *dev, u32 stringset, u8 *dat
 				ETH_GSTRING_LEN);
 			p += ETH_GSTRING_LEN;
 		}
+		for (q = 0; q < priv->plat->rx_queues_to_use; q++) {
+			for (i = 0; i < TC956XMAC_QSTATS_LEN; i++) {
+				snprintf((char *)p, ETH_GSTRING_LEN, "rx_q%d_%s", q,
+					 tc956xmac_qstats_string[i]);
+				p += ETH_GSTRING_LEN;
+			}
+		}
+		for (q = 0; q < priv->plat->tx_queues_to_use; q++) {
+			for (i = 0; i < TC956XMAC_QSTATS_LEN; i++) {
+				snprintf((char *)p, ETH_GSTRING_LEN, "tx_q%d_%s", q,
+					 tc956xmac_qstats_string[i]);
+				p += ETH_GSTRING_LEN;
+			}
+		}
 		break;
 	case ETH_SS_TEST:
 		tc956xmac_selftest_get_strings(priv, p);
@@ -1145,7 +1268,7 @@ static int tc956xmac_ethtool_op_set_eee(struct net_device *dev,
 	return 0;
 }
 
-static u32 tc956xmac_usec2riwt(u32 usec, struct tc956xmac_priv *priv)
+u32 tc956xmac_usec2riwt(u32 usec, struct tc956xmac_priv *priv)
 {
 	unsigned long clk = clk_get_rate(priv->plat->tc956xmac_clk);
 	u32 value, mult = 256;
@@ -1188,33 +1311,77 @@ static u32 tc956xmac_riwt2usec(u32 riwt, struct tc956xmac_priv *priv)
 	return (riwt * mult) / (clk / 1000000);
 }
 
-static int tc956xmac_get_coalesce(struct net_device *dev,
-			       struct ethtool_coalesce *ec)
+static int __tc956xmac_get_coalesce(struct net_device *dev,
+				    struct ethtool_coalesce *ec, int queue)
 {
 	struct tc956xmac_priv *priv = netdev_priv(dev);
+	u32 rx_cnt = priv->plat->rx_queues_to_use;
+	u32 tx_cnt = priv->plat->tx_queues_to_use;
 
-	ec->tx_coalesce_usecs = priv->tx_coal_timer;
-	ec->tx_max_coalesced_frames = priv->tx_coal_frames;
+	if (queue < 0) {
+		ec->tx_coalesce_usecs = priv->tx_coal_timer;
+		ec->tx_max_coalesced_frames = priv->tx_coal_frames;
+
+		if (priv->use_riwt) {
+			ec->rx_max_coalesced_frames = priv->rx_coal_frames;
+			ec->rx_coalesce_usecs = tc956xmac_riwt2usec(priv->rx_riwt, priv);
+		}
+	} else {
+		if (queue >= max(rx_cnt, tx_cnt))
+			return -EINVAL;
 
-	if (priv->use_riwt) {
-		ec->rx_max_coalesced_frames = priv->rx_coal_frames;
-		ec->rx_coalesce_usecs = tc956xmac_riwt2usec(priv->rx_riwt, priv);
+		if (queue < tx_cnt) {
+			ec->tx_coalesce_usecs = priv->tx_queue[queue].tx_coal_timer;
+			ec->tx_max_coalesced_frames =
+				priv->tx_queue[queue].tx_coal_frames;
+		}
+
+		if (queue < rx_cnt && priv->use_riwt) {
+			ec->rx_max_coalesced_frames =
+				priv->rx_queue[queue].rx_coal_frames;
+			ec->rx_coalesce_usecs =
+				tc956xmac_riwt2usec(priv->rx_queue[queue].rx_riwt, priv);
+		}
 	}
 
+	ec->use_adaptive_rx_coalesce = priv->rx_dim_enabled;
+	ec->use_adaptive_tx_coalesce = priv->tx_dim_enabled;
+
 	return 0;
 }
 
-static int tc956xmac_set_coalesce(struct net_device *dev,
+static int tc956xmac_get_coalesce(struct net_device *dev,
 			       struct ethtool_coalesce *ec)
+{
+	return __tc956xmac_get_coalesce(dev, ec, -1);
+}
+
+static int tc956xmac_get_per_queue_coalesce(struct net_device *dev, u32 queue,
+					    struct ethtool_coalesce *ec)
+{
+	return __tc956xmac_get_coalesce(dev, ec, queue);
+}
+
+/**
+ * __tc956xmac_set_coalesce - program the interrupt mitigation
+ * @dev: net device structure
+ * @ec: requested parameters
+ * @queue: channel to update, or -1 for the device default and all channels
+ * Description: DIM stays a device wide setting, while DIM is on the values
+ * given here are only the starting point of the adaptive profile.
+ */
+static int __tc956xmac_set_coalesce(struct net_device *dev,
+				    struct ethtool_coalesce *ec, int queue)
 {
 	struct tc956xmac_priv *priv = netdev_priv(dev);
 	u32 rx_cnt = priv->plat->rx_queues_to_use;
-	unsigned int rx_riwt;
+	u32 tx_cnt = priv->plat->tx_queues_to_use;
+	unsigned int rx_riwt = 0;
+	u32 q;
 
 	/* Check not supported parameters  */
 	if ((ec->rx_coalesce_usecs_irq) ||
 	    (ec->rx_max_coalesced_frames_irq) || (ec->tx_coalesce_usecs_irq) ||
-	    (ec->use_adaptive_rx_coalesce) || (ec->use_adaptive_tx_coalesce) ||
 	    (ec->pkt_rate_low) || (ec->rx_coalesce_usecs_low) ||
 	    (ec->rx_max_coalesced_frames_low) || (ec->tx_coalesce_usecs_high) ||
 	    (ec->tx_max_coalesced_frames_low) || (ec->pkt_rate_high) ||
@@ -1225,6 +1392,18 @@ static int tc956xmac_set_coalesce(struct net_device *dev,
 	    (ec->tx_max_coalesced_frames_high) || (ec->rate_sample_interval))
 		return -EOPNOTSUPP;
 
+	if (ec->use_adaptive_rx_coalesce && !priv->use_riwt)
+		return -EOPNOTSUPP;
+
+	if (queue >= 0) {
+		if (queue >= max(rx_cnt, tx_cnt))
+			return -EINVAL;
+
+		if (!!ec->use_adaptive_rx_coalesce != priv->rx_dim_enabled ||
+		    !!ec->use_adaptive_tx_coalesce != priv->tx_dim_enabled)
+			return -EOPNOTSUPP;
+	}
+
 	if (priv->use_riwt && (ec->rx_coalesce_usecs > 0)) {
 		rx_riwt = tc956xmac_usec2riwt(ec->rx_coalesce_usecs, priv);
 
@@ -1232,9 +1411,6 @@ static int tc956xmac_set_coalesce(struct net_device *dev,
 			KPRINT_DEBUG1("Invalid rx_usecs value 0x%X\n", ec->rx_coalesce_usecs);
 			return -EINVAL;
 		}
-
-		priv->rx_riwt = rx_riwt;
-		tc956xmac_rx_watchdog(priv, priv->ioaddr, priv->rx_riwt, rx_cnt);
 	}
 
 	if (ec->rx_max_coalesced_frames > TC956XMAC_RX_MAX_FRAMES) {
@@ -1251,22 +1427,97 @@ static int tc956xmac_set_coalesce(struct net_device *dev,
 		return -EINVAL;
 
 	/* Only copy relevant parameters, ignore all others. */
-	priv->tx_coal_frames = ec->tx_max_coalesced_frames;
-	priv->tx_coal_timer = ec->tx_coalesce_usecs;
-	priv->rx_coal_frames = ec->rx_max_coalesced_frames;
+	if (queue < 0) {
+		if (rx_riwt)
+			priv->rx_riwt = rx_riwt;
+		priv->tx_coal_frames = ec->tx_max_coalesced_frames;
+		priv->tx_coal_timer = ec->tx_coalesce_usecs;
+		priv->rx_coal_frames = ec->rx_max_coalesced_frames;
+		priv->rx_dim_enabled = !!ec->use_adaptive_rx_coalesce;
+		priv->tx_dim_enabled = !!ec->use_adaptive_tx_coalesce;
+		rx_riwt = priv->rx_riwt;
+	}
+
+	for (q = 0; q < rx_cnt; q++) {
+		struct tc956xmac_rx_queue *rx_q = &priv->rx_queue[q];
+
+		if ((queue >= 0 && q != queue) ||
+		    priv->plat->rx_dma_ch_owner[q] != USE_IN_TC956X_SW)
+			continue;
+
+		if (!priv->rx_dim_enabled)
+			cancel_work_sync(&priv->channel[q].rx_dim.work);
+
+		rx_q->rx_coal_frames = ec->rx_max_coalesced_frames;
+		if (rx_riwt)
+			rx_q->rx_riwt = rx_riwt;
+
+		if (priv->use_riwt)
+			tc956xmac_set_rx_watchdog(priv, priv->ioaddr,
+						  rx_q->rx_riwt, q);
+	}
+
+	for (q = 0; q < tx_cnt; q++) {
+		struct tc956xmac_tx_queue *tx_q = &priv->tx_queue[q];
+
+		if ((queue >= 0 && q != queue) ||
+		    priv->plat->tx_dma_ch_owner[q] != USE_IN_TC956X_SW)
+			continue;
+
+		if (!priv->tx_dim_enabled)
+			cancel_work_sync(&priv->channel[q].tx_dim.work);
+
+		tx_q->tx_coal_frames = ec->tx_max_coalesced_frames;
+		tx_q->tx_coal_timer = ec->tx_coalesce_usecs;
+	}
+
 	return 0;
 }
 
-#ifndef TC956X
+static int tc956xmac_set_coalesce(struct net_device *dev,
+			       struct ethtool_coalesce *ec)
+{
+	return __tc956xmac_set_coalesce(dev, ec, -1);
+}
+
+static int tc956xmac_set_per_queue_coalesce(struct net_device *dev, u32 queue,
+					    struct ethtool_coalesce *ec)
+{
+	return __tc956xmac_set_coalesce(dev, ec, queue);
+}
+
 static int tc956xmac_get_rxnfc(struct net_device *dev,
 			    struct ethtool_rxnfc *rxnfc, u32 *rule_locs)
 {
 	struct tc956xmac_priv *priv = netdev_priv(dev);
 
+	u32 loc, cnt = 0;
+
 	switch (rxnfc->cmd) {
 	case ETHTOOL_GRXRINGS:
 		rxnfc->data = priv->plat->rx_queues_to_use;
 		break;
+	case ETHTOOL_GRXCLSRLCNT:
+		rxnfc->rule_cnt = priv->rx_nfc_count;
+		rxnfc->data = TC956XMAC_RX_NFC_MAX;
+		break;
+	case ETHTOOL_GRXCLSRULE:
+		loc = rxnfc->fs.location;
+		if (loc >= TC956XMAC_RX_NFC_MAX || !priv->rx_nfc[loc].in_use)
+			return -ENOENT;
+		rxnfc->fs = priv->rx_nfc[loc].fs;
+		break;
+	case ETHTOOL_GRXCLSRLALL:
+		for (loc = 0; loc < TC956XMAC_RX_NFC_MAX; loc++) {
+			if (!priv->rx_nfc[loc].in_use)
+				continue;
+			if (cnt == rxnfc->rule_cnt)
+				return -EMSGSIZE;
+			rule_locs[cnt++] = loc;
+		}
+		rxnfc->rule_cnt = cnt;
+		rxnfc->data = TC956XMAC_RX_NFC_MAX;
+		break;
 	default:
 		return -EOPNOTSUPP;
 	}
@@ -1274,10 +1525,27 @@ static int tc956xmac_get_rxnfc(struct net_device *dev,
 	return 0;
 }
 
+static int tc956xmac_set_rxnfc(struct net_device *dev,
+			    struct ethtool_rxnfc *rxnfc)
+{
+	struct tc956xmac_priv *priv = netdev_priv(dev);
+
+	switch (rxnfc->cmd) {
+	case ETHTOOL_SRXCLSRLINS:
+	case ETHTOOL_SRXCLSRLDEL:
+		return tc956xmac_tc_setup_rxnfc(priv, rxnfc);
+	default:
+		return -EOPNOTSUPP;
+	}
+}
+
 static u32 tc956xmac_get_rxfh_key_size(struct net_device *dev)
 {
 	struct tc956xmac_priv *priv = netdev_priv(dev);
 
+	if (!priv->dma_cap.rssen || !priv->plat->rss_en)
+		return 0;
+
 	return sizeof(priv->rss.key);
 }
 
@@ -1285,6 +1553,9 @@ static u32 tc956xmac_get_rxfh_indir_size(struct net_device *dev)
 {
 	struct tc956xmac_priv *priv = netdev_priv(dev);
 
+	if (!priv->dma_cap.rssen || !priv->plat->rss_en)
+		return 0;
+
 	return ARRAY_SIZE(priv->rss.table);
 }
 
@@ -1316,7 +1587,17 @@ static int tc956xmac_set_rxfh(struct net_device *dev, const u32 *indir,
 	if ((hfunc != ETH_RSS_HASH_NO_CHANGE) && (hfunc != ETH_RSS_HASH_TOP))
 		return -EOPNOTSUPP;
 
+	if (!priv->dma_cap.rssen || !priv->plat->rss_en)
+		return -EOPNOTSUPP;
+
 	if (indir) {
+		/* Channels used by an offloader have no host ring behind */
+		for (i = 0; i < ARRAY_SIZE(priv->rss.table); i++) {
+			if (indir[i] >= priv->plat->rx_queues_to_use ||
+			    priv->plat->rx_dma_ch_owner[indir[i]] != USE_IN_TC956X_SW)
+				return -EINVAL;
+		}
+
 		for (i = 0; i < ARRAY_SIZE(priv->rss.table); i++)
 			priv->rss.table[i] = indir[i];
 	}
@@ -1325,9 +1606,8 @@ static int tc956xmac_set_rxfh(struct net_device *dev, const u32 *indir,
 		memcpy(priv->rss.key, key, sizeof(priv->rss.key));
 
 	return tc956xmac_rss_configure(priv, priv->hw, &priv->rss,
-				    priv->plat->rx_queues_to_use);
+				    priv->mtl_rx_queues);
 }
-#endif
 
 static int tc956xmac_get_ts_info(struct net_device *dev,
 			      struct ethtool_ts_info *info)
@@ -1364,7 +1644,6 @@ static int tc956xmac_get_ts_info(struct net_device *dev,
 		return ethtool_op_get_ts_info(dev, info);
 }
 
-#ifndef TC956X
 static int tc956xmac_get_tunable(struct net_device *dev,
 			      const struct ethtool_tunable *tuna, void *data)
 {
@@ -1375,6 +1654,9 @@ static int tc956xmac_get_tunable(struct net_device *dev,
 	case ETHTOOL_RX_COPYBREAK:
 		*(u32 *)data = priv->rx_copybreak;
 		break;
+	case ETHTOOL_TX_COPYBREAK:
+		*(u32 *)data = priv->tx_copybreak;
+		break;
 	default:
 		ret = -EINVAL;
 		break;
@@ -1394,6 +1676,12 @@ static int tc956xmac_set_tunable(struct net_device *dev,
 	case ETHTOOL_RX_COPYBREAK:
 		priv->rx_copybreak = *(u32 *)data;
 		break;
+	case ETHTOOL_TX_COPYBREAK:
+		/* Bounded by the size of the pre-mapped TX buffers */
+		if (*(u32 *)data > TC956XMAC_TX_BOUNCE_SZ)
+			return -EINVAL;
+		priv->tx_copybreak = *(u32 *)data;
+		break;
 	default:
 		ret = -EINVAL;
 		break;
@@ -1401,12 +1689,61 @@ static int tc956xmac_set_tunable(struct net_device *dev,
 
 	return ret;
 }
-#endif
 
 #ifdef TC956X
+static void tc956xmac_get_channels(struct net_device *dev,
+				   struct ethtool_channels *ch)
+{
+	struct tc956xmac_priv *priv = netdev_priv(dev);
+	u32 chan;
+
+	/* Channels held by an offloader are neither counted nor available */
+	for (chan = 0; chan < min_t(u32, dev->num_rx_queues, MTL_MAX_RX_QUEUES);
+	     chan++) {
+		if (priv->plat->rx_dma_ch_owner[chan] == USE_IN_OFFLOADER)
+			continue;
+		ch->max_rx++;
+		if (chan < priv->plat->rx_queues_to_use &&
+		    priv->plat->rx_dma_ch_owner[chan] == USE_IN_TC956X_SW)
+			ch->rx_count++;
+	}
+
+	for (chan = 0; chan < min_t(u32, dev->num_tx_queues, MTL_MAX_TX_QUEUES);
+	     chan++) {
+		if (priv->plat->tx_dma_ch_owner[chan] == USE_IN_OFFLOADER)
+			continue;
+		ch->max_tx++;
+		if (chan < priv->plat->tx_queues_to_use &&
+		    priv->plat->tx_dma_ch_owner[chan] == USE_IN_TC956X_SW)
+			ch->tx_count++;
+	}
+}
+
+static int tc956xmac_set_channels(struct net_device *dev,
+				  struct ethtool_channels *ch)
+{
+	/* TX and RX channels are separate DMA channels */
+	if (ch->combined_count || ch->other_count)
+		return -EINVAL;
+
+	if (!ch->rx_count || !ch->tx_count)
+		return -EINVAL;
+
+	return tc956xmac_reinit_queues(dev, ch->rx_count, ch->tx_count);
+}
+
 static int tc956x_set_priv_flag(struct net_device *dev, u32 priv_flag)
 {
 	struct tc956xmac_priv *priv = netdev_priv(dev);
+	int ret;
+
+	/* Rebuilding the rings goes through open, which resets the FCS mode,
+	 * so the page split mode is applied first.
+	 */
+	ret = tc956xmac_reinit_rx_page_split(dev,
+					     !!(priv_flag & TC956XMAC_RX_PAGE_SPLIT));
+	if (ret)
+		return ret;
 
 	if (priv_flag & TC956XMAC_TX_FCS)
 		priv->tx_crc_pad_state = TC956X_TX_CRC_PAD_INSERT;
@@ -1423,9 +1760,11 @@ static u32 tc956x_get_priv_flag(struct net_device *dev)
 	u32 ret;
 
 	if (priv->tx_crc_pad_state == TC956X_TX_CRC_PAD_INSERT)
-		ret = 1;
+		ret = TC956XMAC_TX_FCS;
 	else
 		ret = 0;
+	if (priv->rx_page_split)
+		ret |= TC956XMAC_RX_PAGE_SPLIT;
 	KPRINT_INFO("tx_crc_pad_state : %x", priv->tx_crc_pad_state);
 	return ret;
 }
@@ -1442,6 +1781,8 @@ static const struct ethtool_ops tc956xmac_ethtool_ops = {
 #ifdef TC956X_UNSUPPORTED_UNTESTED_FEATURE
 	.nway_reset = tc956xmac_nway_reset,
 #endif
+	.get_ringparam = tc956xmac_get_ringparam,
+	.set_ringparam = tc956xmac_set_ringparam,
 	.get_pauseparam = tc956xmac_get_pauseparam,
 	.set_pauseparam = tc956xmac_set_pauseparam,
 	.self_test = tc956xmac_selftest_run,
@@ -1450,25 +1791,26 @@ static const struct ethtool_ops tc956xmac_ethtool_ops = {
 	.get_eee = tc956xmac_ethtool_op_get_eee,
 	.set_eee = tc956xmac_ethtool_op_set_eee,
 	.get_sset_count	= tc956xmac_get_sset_count,
-#ifndef TC956X
 	.get_rxnfc = tc956xmac_get_rxnfc,
+	.set_rxnfc = tc956xmac_set_rxnfc,
 	.get_rxfh_key_size = tc956xmac_get_rxfh_key_size,
 	.get_rxfh_indir_size = tc956xmac_get_rxfh_indir_size,
 	.get_rxfh = tc956xmac_get_rxfh,
 	.set_rxfh = tc956xmac_set_rxfh,
-#endif
 	.get_ts_info = tc956xmac_get_ts_info,
 	.get_coalesce = tc956xmac_get_coalesce,
 	.set_coalesce = tc956xmac_set_coalesce,
-#ifndef TC956X
+	.get_per_queue_coalesce = tc956xmac_get_per_queue_coalesce,
+	.set_per_queue_coalesce = tc956xmac_set_per_queue_coalesce,
 	.get_tunable = tc956xmac_get_tunable,
 	.set_tunable = tc956xmac_set_tunable,
-#endif
 	.get_link_ksettings = tc956xmac_ethtool_get_link_ksettings,
 	.set_link_ksettings = tc956xmac_ethtool_set_link_ksettings,
 #ifdef TC956X
 	.set_priv_flags = tc956x_set_priv_flag,
 	.get_priv_flags = tc956x_get_priv_flag,
+	.get_channels = tc956xmac_get_channels,
+	.set_channels = tc956xmac_set_channels,
 #endif
 };
 
@@ -56,6 +56,8 @@
 #include <linux/net_tstamp.h>
 #include <linux/phylink.h>
 #include <linux/udp.h>
+#include <linux/bpf.h>
+#include <linux/bpf_trace.h>
 #include <net/pkt_cls.h>
 #include "tc956xmac_ptp.h"
 #include "tc956xmac.h"
@@ -89,8 +91,8 @@ static int phyaddr = -1;
 module_param(phyaddr, int, 0444);
 MODULE_PARM_DESC(phyaddr, "Physical device address");
 
-#define TC956XMAC_TX_THRESH	(DMA_TX_SIZE / 4)
-#define TC956XMAC_RX_THRESH	(DMA_RX_SIZE / 4)
+#define TC956XMAC_TX_THRESH(x)	((x)->dma_tx_size / 4)
+#define TC956XMAC_RX_THRESH(x)	((x)->dma_rx_size / 4)
 
 static int flow_ctrl = FLOW_AUTO;
 module_param(flow_ctrl, int, 0644);
@@ -111,6 +113,9 @@ module_param(buf_sz, int, 0644);
 MODULE_PARM_DESC(buf_sz, "DMA buffer size");
 
 #define	TC956XMAC_RX_COPYBREAK	256
+#define	TC956XMAC_TX_COPYBREAK	TC956XMAC_TX_BOUNCE_SZ
+/* RX buffer unavailable interrupts in a row before the channel is restarted */
+#define	TC956XMAC_RBU_STORM	64
 
 static const u32 default_msg_level = (NETIF_MSG_DRV | NETIF_MSG_PROBE |
 				      NETIF_MSG_LINK | NETIF_MSG_IFUP |
@@ -131,6 +136,13 @@ static unsigned int chain_mode;
 module_param(chain_mode, int, 0444);
 MODULE_PARM_DESC(chain_mode, "To use chain instead of ring mode");
 
+/* Best-effort traffic is spread by flow hash over these TX queues, the TSN
+ * classes keep their dedicated channels.
+ */
+static unsigned int tx_be_queues = BIT(HOST_BEST_EFF_CH);
+module_param(tx_be_queues, uint, 0444);
+MODULE_PARM_DESC(tx_be_queues, "Bitmask of the TX queues sharing best-effort traffic");
+
 static irqreturn_t tc956xmac_interrupt(int irq, void *dev_id);
 
 #ifdef CONFIG_DEBUG_FS
@@ -217,11 +229,15 @@ static void tc956xmac_disable_all_queues(struct tc956xmac_priv *priv)
 	for (queue = 0; queue < maxq; queue++) {
 		struct tc956xmac_channel *ch = &priv->channel[queue];
 
-		if (queue < rx_queues_cnt && priv->plat->rx_dma_ch_owner[queue] == USE_IN_TC956X_SW)
+		if (queue < rx_queues_cnt && priv->plat->rx_dma_ch_owner[queue] == USE_IN_TC956X_SW) {
 			napi_disable(&ch->rx_napi);
+			cancel_work_sync(&ch->rx_dim.work);
+		}
 
-		if (queue < tx_queues_cnt && priv->plat->tx_dma_ch_owner[queue] == USE_IN_TC956X_SW)
+		if (queue < tx_queues_cnt && priv->plat->tx_dma_ch_owner[queue] == USE_IN_TC956X_SW) {
 			napi_disable(&ch->tx_napi);
+			cancel_work_sync(&ch->tx_dim.work);
+		}
 	}
 }
 
@@ -301,6 +317,26 @@ static void tc956xmac_global_err(struct tc956xmac_priv *priv)
 #endif
 }
 
+/**
+ * tc956xmac_chan_err - request the restart of one DMA channel
+ * @priv: driver private structure
+ * @chan: channel index
+ * @tx: restart the TX path of the channel
+ * @rx: restart the RX path of the channel
+ * Description: can be called from interrupt context, the channel is
+ * restarted later by tc956xmac_chan_reset_task.
+ */
+static void tc956xmac_chan_err(struct tc956xmac_priv *priv, u32 chan,
+			       bool tx, bool rx)
+{
+	if (tx)
+		set_bit(chan, &priv->tx_reset_mask);
+	if (rx)
+		set_bit(chan, &priv->rx_reset_mask);
+
+	schedule_work(&priv->chan_reset_task);
+}
+
 #ifdef TC956X_UNSUPPORTED_UNTESTED_FEATURE
 /**
  * tc956xmac_clk_csr_set - dynamically set the MDC clock
@@ -378,16 +414,46 @@ static void print_pkt(unsigned char *buf, int len)
 static inline u32 tc956xmac_tx_avail(struct tc956xmac_priv *priv, u32 queue)
 {
 	struct tc956xmac_tx_queue *tx_q = &priv->tx_queue[queue];
+	/* Pairs with the release in tc956xmac_tx_clean */
+	u32 dirty_tx = smp_load_acquire(&tx_q->dirty_tx);
 	u32 avail;
 
-	if (tx_q->dirty_tx > tx_q->cur_tx)
-		avail = tx_q->dirty_tx - tx_q->cur_tx - 1;
+	if (dirty_tx > tx_q->cur_tx)
+		avail = dirty_tx - tx_q->cur_tx - 1;
 	else
-		avail = DMA_TX_SIZE - tx_q->cur_tx + tx_q->dirty_tx - 1;
+		avail = tx_q->dma_tx_size - tx_q->cur_tx + dirty_tx - 1;
 
 	return avail;
 }
 
+/**
+ * tc956xmac_tx_maybe_stop - stop a TX queue running out of descriptors
+ * @priv: driver private structure
+ * @queue: TX queue index
+ * @needed: descriptors that must stay available for the next frame
+ * Description: tx_clean runs without the TX queue lock, so once the queue
+ * is stopped the free space is checked again. Either this sees the entries
+ * released by tx_clean, or tx_clean sees the stopped queue and wakes it.
+ */
+static inline void tc956xmac_tx_maybe_stop(struct tc956xmac_priv *priv,
+					   u32 queue, u32 needed)
+{
+	struct netdev_queue *txq = netdev_get_tx_queue(priv->dev, queue);
+
+	if (likely(tc956xmac_tx_avail(priv, queue) > needed))
+		return;
+
+	netif_dbg(priv, hw, priv->dev, "%s: stop transmitted packets\n",
+		  __func__);
+	netif_tx_stop_queue(txq);
+
+	/* Pairs with the smp_mb() in tc956xmac_tx_clean */
+	smp_mb();
+
+	if (unlikely(tc956xmac_tx_avail(priv, queue) > needed))
+		netif_tx_start_queue(txq);
+}
+
 /**
  * tc956xmac_rx_dirty - Get RX queue dirty
  * @priv: driver private structure
@@ -401,7 +467,7 @@ static inline u32 tc956xmac_rx_dirty(struct tc956xmac_priv *priv, u32 queue)
 	if (rx_q->dirty_rx <= rx_q->cur_rx)
 		dirty = rx_q->cur_rx - rx_q->dirty_rx;
 	else
-		dirty = DMA_RX_SIZE - rx_q->dirty_rx + rx_q->cur_rx;
+		dirty = rx_q->dma_rx_size - rx_q->dirty_rx + rx_q->cur_rx;
 
 	return dirty;
 }
@@ -1611,7 +1677,7 @@ static void tc956xmac_display_rx_rings(struct tc956xmac_priv *priv)
 			head_rx = (void *)rx_q->dma_rx;
 
 		/* Display RX ring */
-		tc956xmac_display_ring(priv, head_rx, DMA_RX_SIZE, true);
+		tc956xmac_display_ring(priv, head_rx, rx_q->dma_rx_size, true);
 	}
 }
 
@@ -1637,7 +1703,7 @@ static void tc956xmac_display_tx_rings(struct tc956xmac_priv *priv)
 		else
 			head_tx = (void *)tx_q->dma_tx;
 
-		tc956xmac_display_ring(priv, head_tx, DMA_TX_SIZE, false);
+		tc956xmac_display_ring(priv, head_tx, tx_q->dma_tx_size, false);
 	}
 }
 
@@ -1668,6 +1734,56 @@ static int tc956xmac_set_bfsize(int mtu, int bufsize)
 	return ret;
 }
 
+/**
+ * tc956xmac_rx_max_bfsize - largest RX buffer backed by an order-0 page
+ * @priv: driver private structure
+ * Description: without split header the first buffer of a frame is handed to
+ * build_skb, so the headroom and the skb_shared_info have to fit in the same
+ * page. Frames longer than this are received over several descriptors.
+ */
+static int tc956xmac_rx_max_bfsize(struct tc956xmac_priv *priv)
+{
+	unsigned int headroom = tc956xmac_xdp_is_enabled(priv) ?
+				XDP_PACKET_HEADROOM : NET_SKB_PAD;
+
+	if (priv->sph)
+		return PAGE_SIZE;
+
+	return ALIGN_DOWN(SKB_WITH_OVERHEAD(PAGE_SIZE) -
+			  SKB_DATA_ALIGN(headroom), SMP_CACHE_BYTES);
+}
+
+/**
+ * tc956xmac_rx_bfsize - RX DMA buffer size for a given MTU
+ * @priv: driver private structure
+ * @mtu: MTU the buffers are sized for
+ */
+static int tc956xmac_rx_bfsize(struct tc956xmac_priv *priv, int mtu)
+{
+	int bfsize;
+
+	/* Headers are split off by the DMA and the payload is written
+	 * one order-0 page per descriptor, starting at offset 0, so
+	 * that TCP zero-copy receive can map it into user space. Larger
+	 * frames span several descriptors.
+	 */
+	if (priv->sph && priv->rx_page_split)
+		return PAGE_SIZE;
+
+	bfsize = tc956xmac_set_16kib_bfsize(priv, mtu);
+	if (bfsize < 0)
+		bfsize = 0;
+
+	if (bfsize < BUF_SIZE_16KiB)
+		bfsize = tc956xmac_set_bfsize(mtu, priv->dma_buf_sz);
+
+	/* Jumbo frames are chained over several order-0 buffers rather
+	 * than received in high order pages, which become hard to
+	 * allocate once memory is fragmented.
+	 */
+	return min(bfsize, tc956xmac_rx_max_bfsize(priv));
+}
+
 /**
  * tc956xmac_clear_rx_descriptors - clear RX descriptors
  * @priv: driver private structure
@@ -1681,17 +1797,17 @@ static void tc956xmac_clear_rx_descriptors(struct tc956xmac_priv *priv, u32 queu
 	int i;
 
 	/* Clear the RX descriptors */
-	for (i = 0; i < DMA_RX_SIZE; i++)
+	for (i = 0; i < rx_q->dma_rx_size; i++)
 		if (priv->extend_desc)
 			tc956xmac_init_rx_desc(priv, &rx_q->dma_erx[i].basic,
 					priv->use_riwt, priv->mode,
-					(i == DMA_RX_SIZE - 1),
-					priv->dma_buf_sz);
+					(i == rx_q->dma_rx_size - 1),
+					rx_q->dma_buf_sz);
 		else
 			tc956xmac_init_rx_desc(priv, &rx_q->dma_rx[i],
 					priv->use_riwt, priv->mode,
-					(i == DMA_RX_SIZE - 1),
-					priv->dma_buf_sz);
+					(i == rx_q->dma_rx_size - 1),
+					rx_q->dma_buf_sz);
 }
 
 /**
@@ -1707,8 +1823,8 @@ static void tc956xmac_clear_tx_descriptors(struct tc956xmac_priv *priv, u32 queu
 	int i;
 
 	/* Clear the TX descriptors */
-	for (i = 0; i < DMA_TX_SIZE; i++) {
-		int last = (i == (DMA_TX_SIZE - 1));
+	for (i = 0; i < tx_q->dma_tx_size; i++) {
+		int last = (i == (tx_q->dma_tx_size - 1));
 		struct dma_desc *p;
 
 		if (priv->extend_desc)
@@ -1754,6 +1870,61 @@ static void tc956xmac_clear_descriptors(struct tc956xmac_priv *priv)
 	}
 }
 
+/**
+ * tc956xmac_alloc_rx_buffer_zc - take a RX buffer from the AF_XDP fill queue
+ * @rx_q: RX queue bound to an AF_XDP socket
+ * @buf: buffer slot to fill
+ * Description: recycled chunks are consumed before the fill queue. Returns
+ * false when userspace has not posted any chunk yet.
+ */
+static bool tc956xmac_alloc_rx_buffer_zc(struct tc956xmac_rx_queue *rx_q,
+					 struct tc956xmac_rx_buffer *buf)
+{
+	struct xdp_umem *umem = rx_q->xsk_umem;
+	u64 hr = umem->headroom + XDP_PACKET_HEADROOM;
+	u64 handle;
+
+	if (!xsk_umem_peek_addr_rq(umem, &handle))
+		return false;
+
+	buf->addr = xdp_umem_get_dma(umem, handle) + hr;
+	buf->xsk_data = xdp_umem_get_data(umem, handle) + hr;
+	buf->xsk_handle = xsk_umem_adjust_offset(umem, handle, umem->headroom);
+
+	xsk_umem_discard_addr_rq(umem);
+
+	return true;
+}
+
+/**
+ * tc956xmac_recycle_rx_buffer_zc - give a RX chunk back to the AF_XDP socket
+ * @rx_q: RX queue bound to an AF_XDP socket
+ * @buf: buffer slot to release
+ */
+static void tc956xmac_recycle_rx_buffer_zc(struct tc956xmac_rx_queue *rx_q,
+					   struct tc956xmac_rx_buffer *buf)
+{
+	xsk_umem_fq_reuse(rx_q->xsk_umem,
+			  buf->xsk_handle & rx_q->xsk_umem->chunk_mask);
+	buf->xsk_data = NULL;
+}
+
+/**
+ * tc956xmac_zca_free - zero-copy allocator release callback
+ * @alloc: allocator embedded in the RX queue
+ * @handle: UMEM handle of the released chunk
+ * Description: called by the XDP core once it is done with a chunk, e.g.
+ * after copying it out for XDP_TX.
+ */
+static void tc956xmac_zca_free(struct zero_copy_allocator *alloc,
+			       unsigned long handle)
+{
+	struct tc956xmac_rx_queue *rx_q =
+		container_of(alloc, struct tc956xmac_rx_queue, zca);
+
+	xsk_umem_fq_reuse(rx_q->xsk_umem, handle & rx_q->xsk_umem->chunk_mask);
+}
+
 /**
  * tc956xmac_init_rx_buffers - init the RX descriptor buffer.
  * @priv: driver private structure
@@ -1786,7 +1957,7 @@ static int tc956xmac_init_rx_buffers(struct tc956xmac_priv *priv, struct dma_des
 	}
 
 	buf->addr = page_pool_get_dma_addr(buf->page);
-	tc956xmac_set_desc_addr(priv, p, buf->addr);
+	tc956xmac_set_desc_addr(priv, p, buf->addr + tc956xmac_rx_offset(priv));
 	if (priv->dma_buf_sz == BUF_SIZE_16KiB)
 		tc956xmac_init_desc3(priv, p);
 
@@ -1804,6 +1975,9 @@ static void tc956xmac_free_rx_buffer(struct tc956xmac_priv *priv, u32 queue, int
 	struct tc956xmac_rx_queue *rx_q = &priv->rx_queue[queue];
 	struct tc956xmac_rx_buffer *buf = &rx_q->buf_pool[i];
 
+	if (buf->xsk_data)
+		tc956xmac_recycle_rx_buffer_zc(rx_q, buf);
+
 	if (buf->page)
 		page_pool_put_page(rx_q->page_pool, buf->page, false);
 	buf->page = NULL;
@@ -1823,7 +1997,13 @@ static void tc956xmac_free_tx_buffer(struct tc956xmac_priv *priv, u32 queue, int
 {
 	struct tc956xmac_tx_queue *tx_q = &priv->tx_queue[queue];
 
-	if (tx_q->tx_skbuff_dma[i].buf) {
+	if (tx_q->tx_skbuff_dma[i].buf_type == TC956XMAC_TXBUF_T_XSK_TX)
+		xsk_umem_complete_tx(tx_q->xsk_umem, 1);
+
+	if (tx_q->tx_skbuff_dma[i].buf &&
+	    tx_q->tx_skbuff_dma[i].buf_type != TC956XMAC_TXBUF_T_XDP_TX &&
+	    tx_q->tx_skbuff_dma[i].buf_type != TC956XMAC_TXBUF_T_XSK_TX &&
+	    tx_q->tx_skbuff_dma[i].buf_type != TC956XMAC_TXBUF_T_BOUNCE) {
 		if (tx_q->tx_skbuff_dma[i].map_as_page)
 			dma_unmap_page(priv->device,
 				       tx_q->tx_skbuff_dma[i].buf,
@@ -1836,12 +2016,44 @@ static void tc956xmac_free_tx_buffer(struct tc956xmac_priv *priv, u32 queue, int
 					 DMA_TO_DEVICE);
 	}
 
+	if (tx_q->xdpf[i]) {
+		xdp_return_frame(tx_q->xdpf[i]);
+		tx_q->xdpf[i] = NULL;
+	}
+
 	if (tx_q->tx_skbuff[i]) {
 		dev_kfree_skb_any(tx_q->tx_skbuff[i]);
 		tx_q->tx_skbuff[i] = NULL;
-		tx_q->tx_skbuff_dma[i].buf = 0;
-		tx_q->tx_skbuff_dma[i].map_as_page = false;
 	}
+
+	tx_q->tx_skbuff_dma[i].buf = 0;
+	tx_q->tx_skbuff_dma[i].map_as_page = false;
+	tx_q->tx_skbuff_dma[i].buf_type = TC956XMAC_TXBUF_T_SKB;
+}
+
+/**
+ * tc956xmac_rx_use_wd - RX interrupt coalescing of a refilled descriptor
+ * @priv: driver private structure
+ * @rx_q: RX queue being refilled
+ * Description: returns true when the descriptor completion must be left to
+ * the RX watchdog instead of raising an interrupt.
+ */
+static bool tc956xmac_rx_use_wd(struct tc956xmac_priv *priv,
+				struct tc956xmac_rx_queue *rx_q)
+{
+	bool use_rx_wd;
+
+	rx_q->rx_count_frames++;
+	rx_q->rx_count_frames += rx_q->rx_coal_frames;
+	if (rx_q->rx_count_frames > rx_q->rx_coal_frames)
+		rx_q->rx_count_frames = 0;
+
+	use_rx_wd = !rx_q->rx_coal_frames;
+	use_rx_wd |= rx_q->rx_count_frames > 0;
+	if (!priv->use_riwt)
+		use_rx_wd = false;
+
+	return use_rx_wd;
 }
 
 /**
@@ -1877,9 +2089,17 @@ static int init_dma_rx_desc_rings(struct net_device *dev, gfp_t flags)
 			  "(%s) dma_rx_phy=0x%08x\n", __func__,
 			  (u32)rx_q->dma_rx_phy);
 
-		tc956xmac_clear_rx_descriptors(priv, queue);
+		rx_q->dma_buf_sz = priv->dma_buf_sz;
+		if (rx_q->xsk_umem)
+			/* Only slots holding a UMEM chunk are given to the DMA */
+			memset(priv->extend_desc ? (void *)rx_q->dma_erx :
+			       (void *)rx_q->dma_rx, 0, rx_q->dma_rx_size *
+			       (priv->extend_desc ? sizeof(struct dma_extended_desc) :
+				sizeof(struct dma_desc)));
+		else
+			tc956xmac_clear_rx_descriptors(priv, queue);
 
-		for (i = 0; i < DMA_RX_SIZE; i++) {
+		for (i = 0; i < rx_q->dma_rx_size; i++) {
 			struct dma_desc *p;
 
 			if (priv->extend_desc)
@@ -1887,6 +2107,22 @@ static int init_dma_rx_desc_rings(struct net_device *dev, gfp_t flags)
 			else
 				p = rx_q->dma_rx + i;
 
+			if (rx_q->xsk_umem) {
+				/* The fill queue may hold less than a ring,
+				 * the remaining slots are refilled by NAPI.
+				 */
+				if (!tc956xmac_alloc_rx_buffer_zc(rx_q,
+						&rx_q->buf_pool[i]))
+					break;
+				tc956xmac_set_desc_addr(priv, p,
+						rx_q->buf_pool[i].addr);
+				tc956xmac_set_desc_sec_addr(priv, p, 0);
+				tc956xmac_refill_desc3(priv, rx_q, p);
+				tc956xmac_set_rx_owner(priv, p,
+					tc956xmac_rx_use_wd(priv, rx_q));
+				continue;
+			}
+
 			ret = tc956xmac_init_rx_buffers(priv, p, i, flags,
 						     queue);
 			if (ret)
@@ -1894,16 +2130,21 @@ static int init_dma_rx_desc_rings(struct net_device *dev, gfp_t flags)
 		}
 
 		rx_q->cur_rx = 0;
-		rx_q->dirty_rx = (unsigned int)(i - DMA_RX_SIZE);
+		rx_q->dirty_rx = (unsigned int)(i - rx_q->dma_rx_size);
+		if (rx_q->xsk_umem) {
+			rx_q->xsk_armed = i;
+			rx_q->dirty_rx = i % rx_q->dma_rx_size;
+			rx_q->state.error = 0;
+		}
 
 		/* Setup the chained descriptor addresses */
 		if (priv->mode == TC956XMAC_CHAIN_MODE) {
 			if (priv->extend_desc)
 				tc956xmac_mode_init(priv, rx_q->dma_erx,
-						rx_q->dma_rx_phy, DMA_RX_SIZE, 1);
+						rx_q->dma_rx_phy, rx_q->dma_rx_size, 1);
 			else
 				tc956xmac_mode_init(priv, rx_q->dma_rx,
-						rx_q->dma_rx_phy, DMA_RX_SIZE, 0);
+						rx_q->dma_rx_phy, rx_q->dma_rx_size, 0);
 		}
 	}
 
@@ -1917,8 +2158,8 @@ err_init_rx_buffers:
 		if (queue == 0)
 			break;
 
-		i = DMA_RX_SIZE;
 		queue--;
+		i = priv->rx_queue[queue].dma_rx_size;
 	}
 
 	return ret;
@@ -1952,13 +2193,13 @@ static int init_dma_tx_desc_rings(struct net_device *dev)
 		if (priv->mode == TC956XMAC_CHAIN_MODE) {
 			if (priv->extend_desc)
 				tc956xmac_mode_init(priv, tx_q->dma_etx,
-						tx_q->dma_tx_phy, DMA_TX_SIZE, 1);
+						tx_q->dma_tx_phy, tx_q->dma_tx_size, 1);
 			else if (!(tx_q->tbs & TC956XMAC_TBS_AVAIL))
 				tc956xmac_mode_init(priv, tx_q->dma_tx,
-						tx_q->dma_tx_phy, DMA_TX_SIZE, 0);
+						tx_q->dma_tx_phy, tx_q->dma_tx_size, 0);
 		}
 
-		for (i = 0; i < DMA_TX_SIZE; i++) {
+		for (i = 0; i < tx_q->dma_tx_size; i++) {
 			struct dma_desc *p;
 
 			if (priv->extend_desc)
@@ -1974,11 +2215,14 @@ static int init_dma_tx_desc_rings(struct net_device *dev)
 			tx_q->tx_skbuff_dma[i].map_as_page = false;
 			tx_q->tx_skbuff_dma[i].len = 0;
 			tx_q->tx_skbuff_dma[i].last_segment = false;
+			tx_q->tx_skbuff_dma[i].buf_type = TC956XMAC_TXBUF_T_SKB;
 			tx_q->tx_skbuff[i] = NULL;
+			tx_q->xdpf[i] = NULL;
 		}
 
 		tx_q->dirty_tx = 0;
 		tx_q->cur_tx = 0;
+		tx_q->tail_tx = 0;
 		tx_q->mss = 0;
 
 		netdev_tx_reset_queue(netdev_get_tx_queue(priv->dev, queue));
@@ -2021,9 +2265,10 @@ static int init_dma_desc_rings(struct net_device *dev, gfp_t flags)
  */
 static void dma_free_rx_skbufs(struct tc956xmac_priv *priv, u32 queue)
 {
+	struct tc956xmac_rx_queue *rx_q = &priv->rx_queue[queue];
 	int i;
 
-	for (i = 0; i < DMA_RX_SIZE; i++)
+	for (i = 0; i < rx_q->dma_rx_size; i++)
 		tc956xmac_free_rx_buffer(priv, queue, i);
 }
 
@@ -2034,9 +2279,10 @@ static void dma_free_rx_skbufs(struct tc956xmac_priv *priv, u32 queue)
  */
 static void dma_free_tx_skbufs(struct tc956xmac_priv *priv, u32 queue)
 {
+	struct tc956xmac_tx_queue *tx_q = &priv->tx_queue[queue];
 	int i;
 
-	for (i = 0; i < DMA_TX_SIZE; i++)
+	for (i = 0; i < tx_q->dma_tx_size; i++)
 		tc956xmac_free_tx_buffer(priv, queue, i);
 }
 
@@ -2065,14 +2311,16 @@ static void free_dma_rx_desc_resources(struct tc956xmac_priv *priv)
 		/* Free DMA regions of consistent memory previously allocated */
 		if (!priv->extend_desc)
 			dma_free_coherent(priv->device,
-					  DMA_RX_SIZE * sizeof(struct dma_desc),
+					  rx_q->dma_rx_size * sizeof(struct dma_desc),
 					  rx_q->dma_rx, rx_q->dma_rx_phy);
 		else
-			dma_free_coherent(priv->device, DMA_RX_SIZE *
+			dma_free_coherent(priv->device, rx_q->dma_rx_size *
 					  sizeof(struct dma_extended_desc),
 					  rx_q->dma_erx, rx_q->dma_rx_phy);
 
 		kfree(rx_q->buf_pool);
+		if (xdp_rxq_info_is_reg(&rx_q->xdp_rxq))
+			xdp_rxq_info_unreg(&rx_q->xdp_rxq);
 		if (rx_q->page_pool)
 			page_pool_destroy(rx_q->page_pool);
 	}
@@ -2110,12 +2358,19 @@ static void free_dma_tx_desc_resources(struct tc956xmac_priv *priv)
 			addr = tx_q->dma_tx;
 		}
 
-		size *= DMA_TX_SIZE;
+		size *= tx_q->dma_tx_size;
 
 		dma_free_coherent(priv->device, size, addr, tx_q->dma_tx_phy);
 
+		if (tx_q->tx_bounce)
+			dma_free_coherent(priv->device, tx_q->dma_tx_size *
+					  TC956XMAC_TX_BOUNCE_SZ,
+					  tx_q->tx_bounce, tx_q->tx_bounce_dma);
+		tx_q->tx_bounce = NULL;
+
 		kfree(tx_q->tx_skbuff_dma);
 		kfree(tx_q->tx_skbuff);
+		kfree(tx_q->xdpf);
 	}
 }
 
@@ -2140,7 +2395,6 @@ static int alloc_dma_rx_desc_resources(struct tc956xmac_priv *priv)
 	for (queue = 0; queue < rx_count; queue++) {
 		struct tc956xmac_rx_queue *rx_q = &priv->rx_queue[queue];
 		struct page_pool_params pp_params = { 0 };
-		unsigned int num_pages;
 
 		/* Create Rx DMA resources for Host owned channels only */
 		if (priv->plat->rx_dma_ch_owner[queue] != USE_IN_TC956X_SW)
@@ -2148,30 +2402,52 @@ static int alloc_dma_rx_desc_resources(struct tc956xmac_priv *priv)
 
 		rx_q->queue_index = queue;
 		rx_q->priv_data = priv;
+		rx_q->dma_rx_size = priv->dma_rx_size;
+		rx_q->xsk_umem = tc956xmac_xsk_umem(priv, queue);
+
+		/* AF_XDP zero-copy queues take their buffers from the UMEM */
+		if (!rx_q->xsk_umem) {
+			pp_params.flags = PP_FLAG_DMA_MAP;
+			pp_params.pool_size = rx_q->dma_rx_size;
+			pp_params.order = tc956xmac_rx_page_order(priv);
+			pp_params.nid = dev_to_node(priv->device);
+			pp_params.dev = priv->device;
+			pp_params.dma_dir = tc956xmac_rx_dma_dir(priv);
+
+			rx_q->page_pool = page_pool_create(&pp_params);
+			if (IS_ERR(rx_q->page_pool)) {
+				ret = PTR_ERR(rx_q->page_pool);
+				rx_q->page_pool = NULL;
+				goto err_dma;
+			}
+		}
 
-		pp_params.flags = PP_FLAG_DMA_MAP;
-		pp_params.pool_size = DMA_RX_SIZE;
-		num_pages = DIV_ROUND_UP(priv->dma_buf_sz, PAGE_SIZE);
-		pp_params.order = ilog2(num_pages);
-		pp_params.nid = dev_to_node(priv->device);
-		pp_params.dev = priv->device;
-		pp_params.dma_dir = DMA_FROM_DEVICE;
-
-		rx_q->page_pool = page_pool_create(&pp_params);
-		if (IS_ERR(rx_q->page_pool)) {
-			ret = PTR_ERR(rx_q->page_pool);
-			rx_q->page_pool = NULL;
+		ret = xdp_rxq_info_reg(&rx_q->xdp_rxq, priv->dev, queue);
+		if (ret)
 			goto err_dma;
+
+		if (rx_q->xsk_umem) {
+			rx_q->zca.free = tc956xmac_zca_free;
+			ret = xdp_rxq_info_reg_mem_model(&rx_q->xdp_rxq,
+							 MEM_TYPE_ZERO_COPY,
+							 &rx_q->zca);
+		} else {
+			ret = xdp_rxq_info_reg_mem_model(&rx_q->xdp_rxq,
+							 MEM_TYPE_PAGE_POOL,
+							 rx_q->page_pool);
 		}
+		if (ret)
+			goto err_dma;
+		ret = -ENOMEM;
 
-		rx_q->buf_pool = kcalloc(DMA_RX_SIZE, sizeof(*rx_q->buf_pool),
+		rx_q->buf_pool = kcalloc(rx_q->dma_rx_size, sizeof(*rx_q->buf_pool),
 					 GFP_KERNEL);
 		if (!rx_q->buf_pool)
 			goto err_dma;
 
 		if (priv->extend_desc) {
 			rx_q->dma_erx = dma_alloc_coherent(priv->device,
-							   DMA_RX_SIZE * sizeof(struct dma_extended_desc),
+							   rx_q->dma_rx_size * sizeof(struct dma_extended_desc),
 							   &rx_q->dma_rx_phy,
 							   GFP_KERNEL);
 			if (!rx_q->dma_erx)
@@ -2179,7 +2455,7 @@ static int alloc_dma_rx_desc_resources(struct tc956xmac_priv *priv)
 
 		} else {
 			rx_q->dma_rx = dma_alloc_coherent(priv->device,
-							  DMA_RX_SIZE * sizeof(struct dma_desc),
+							  rx_q->dma_rx_size * sizeof(struct dma_desc),
 							  &rx_q->dma_rx_phy,
 							  GFP_KERNEL);
 			if (!rx_q->dma_rx)
@@ -2220,19 +2496,26 @@ static int alloc_dma_tx_desc_resources(struct tc956xmac_priv *priv)
 
 		tx_q->queue_index = queue;
 		tx_q->priv_data = priv;
+		tx_q->dma_tx_size = priv->dma_tx_size;
+		tx_q->xsk_umem = tc956xmac_xsk_umem(priv, queue);
 
-		tx_q->tx_skbuff_dma = kcalloc(DMA_TX_SIZE,
+		tx_q->tx_skbuff_dma = kcalloc(tx_q->dma_tx_size,
 					      sizeof(*tx_q->tx_skbuff_dma),
 					      GFP_KERNEL);
 		if (!tx_q->tx_skbuff_dma)
 			goto err_dma;
 
-		tx_q->tx_skbuff = kcalloc(DMA_TX_SIZE,
+		tx_q->tx_skbuff = kcalloc(tx_q->dma_tx_size,
 					  sizeof(struct sk_buff *),
 					  GFP_KERNEL);
 		if (!tx_q->tx_skbuff)
 			goto err_dma;
 
+		tx_q->xdpf = kcalloc(tx_q->dma_tx_size, sizeof(*tx_q->xdpf),
+				     GFP_KERNEL);
+		if (!tx_q->xdpf)
+			goto err_dma;
+
 		if (priv->extend_desc)
 			size = sizeof(struct dma_extended_desc);
 		else if (tx_q->tbs & TC956XMAC_TBS_AVAIL)
@@ -2240,7 +2523,7 @@ static int alloc_dma_tx_desc_resources(struct tc956xmac_priv *priv)
 		else
 			size = sizeof(struct dma_desc);
 
-		size *= DMA_TX_SIZE;
+		size *= tx_q->dma_tx_size;
 
 		addr = dma_alloc_coherent(priv->device, size,
 					  &tx_q->dma_tx_phy, GFP_KERNEL);
@@ -2253,6 +2536,17 @@ static int alloc_dma_tx_desc_resources(struct tc956xmac_priv *priv)
 			tx_q->dma_entx = addr;
 		else
 			tx_q->dma_tx = addr;
+
+		/* Mapped once here, so that small frames do not pay a DMA
+		 * map and unmap (an IOTLB update behind an IOMMU) each.
+		 */
+		tx_q->tx_bounce = dma_alloc_coherent(priv->device,
+						     tx_q->dma_tx_size *
+						     TC956XMAC_TX_BOUNCE_SZ,
+						     &tx_q->tx_bounce_dma,
+						     GFP_KERNEL);
+		if (!tx_q->tx_bounce)
+			goto err_dma;
 	}
 
 	return 0;
@@ -2303,7 +2597,7 @@ static void free_dma_desc_resources(struct tc956xmac_priv *priv)
  */
 static void tc956xmac_mac_enable_rx_queues(struct tc956xmac_priv *priv)
 {
-	u32 rx_queues_count = priv->plat->rx_queues_to_use;
+	u32 rx_queues_count = priv->mtl_rx_queues;
 	int queue;
 	u8 mode;
 
@@ -2427,6 +2721,43 @@ static void tc956xmac_stop_all_dma(struct tc956xmac_priv *priv)
  *  Description: it is used for configuring the DMA operation mode register in
  *  order to program the tx/rx DMA thresholds or Store-And-Forward mode.
  */
+#ifdef TC956X
+/**
+ * tc956xmac_tx_queue_fifo_size - TX FIFO of a queue in the platform setup
+ * @queue: MTL TX queue index
+ */
+static int tc956xmac_tx_queue_fifo_size(u32 queue)
+{
+	switch (queue) {
+	case 0:
+		return TX_QUEUE0_SIZE;
+	case 1:
+		return TX_QUEUE1_SIZE;
+	case 2:
+		return TX_QUEUE2_SIZE;
+	case 3:
+		return TX_QUEUE3_SIZE;
+	case 4:
+		return TX_QUEUE4_SIZE;
+	case 5:
+		return TX_QUEUE5_SIZE;
+	case 6:
+		return TX_QUEUE6_SIZE;
+	case 7:
+		return TX_QUEUE7_SIZE;
+	default:
+		return TX_QUEUE0_SIZE;
+	}
+}
+
+/* TX runs in store and forward, a whole frame has to fit in a queue */
+static bool tc956xmac_tx_fifo_fits(u32 fifosz, int mtu)
+{
+	return !fifosz ||
+	       fifosz >= mtu + ETH_HLEN + 2 * VLAN_HLEN + ETH_FCS_LEN;
+}
+#endif
+
 static void tc956xmac_dma_operation_mode(struct tc956xmac_priv *priv)
 {
 	u32 rx_channels_count = priv->plat->rx_queues_to_use;
@@ -2502,47 +2833,30 @@ static void tc956xmac_dma_operation_mode(struct tc956xmac_priv *priv)
 
 		qmode = priv->plat->rx_queues_cfg[chan].mode_to_use;
 
-		tc956xmac_dma_rx_mode(priv, priv->ioaddr, rxmode, chan,
-				rxfifosz, qmode);
+#ifdef TC956X
+		/* Channels added by ethtool -L are reached through RSS and
+		 * have no MTL queue, so no FIFO is taken for them.
+		 */
+		if (chan < priv->mtl_rx_queues)
+#endif
+			tc956xmac_dma_rx_mode(priv, priv->ioaddr, rxmode, chan,
+					rxfifosz, qmode);
 #ifdef TC956X
 		if (priv->plat->rx_dma_ch_owner[chan] == USE_IN_TC956X_SW)
-			tc956xmac_set_dma_bfsize(priv, priv->ioaddr, priv->dma_buf_sz,
-						chan);
+			tc956xmac_set_dma_bfsize(priv, priv->ioaddr,
+						priv->rx_queue[chan].dma_buf_sz, chan);
 #endif
 
 	}
 
 	for (chan = 0; chan < tx_channels_count; chan++) {
 #ifdef TC956X
-		switch (chan) {
-		case 0:
-			txfifosz = TX_QUEUE0_SIZE;
-			break;
-		case 1:
-			txfifosz = TX_QUEUE1_SIZE;
-			break;
-		case 2:
-			txfifosz = TX_QUEUE2_SIZE;
-			break;
-		case 3:
-			txfifosz = TX_QUEUE3_SIZE;
-			break;
-		case 4:
-			txfifosz = TX_QUEUE4_SIZE;
-			break;
-		case 5:
-			txfifosz = TX_QUEUE5_SIZE;
-			break;
-		case 6:
-			txfifosz = TX_QUEUE6_SIZE;
-			break;
-		case 7:
-			txfifosz = TX_QUEUE7_SIZE;
-			break;
-		default:
-			txfifosz = TX_QUEUE0_SIZE;
-			break;
-		}
+		/* Offloader queues keep their FIFO, the host ones share the rest */
+		if (priv->tx_fifo_split &&
+		    priv->plat->tx_dma_ch_owner[chan] != USE_IN_OFFLOADER)
+			txfifosz = priv->tx_fifo_split;
+		else
+			txfifosz = tc956xmac_tx_queue_fifo_size(chan);
 #endif
 
 		qmode = priv->plat->tx_queues_cfg[chan].mode_to_use;
@@ -2561,16 +2875,21 @@ static void tc956xmac_dma_operation_mode(struct tc956xmac_priv *priv)
 static int tc956xmac_tx_clean(struct tc956xmac_priv *priv, int budget, u32 queue)
 {
 	struct tc956xmac_tx_queue *tx_q = &priv->tx_queue[queue];
-	unsigned int bytes_compl = 0, pkts_compl = 0;
-	unsigned int entry, count = 0;
-
-	__netif_tx_lock_bh(netdev_get_tx_queue(priv->dev, queue));
+	unsigned int bytes_compl = 0, pkts_compl = 0, xsk_frames = 0;
+	unsigned int tx_packets = 0, tx_errors = 0;
+	unsigned int entry, tail_tx, count = 0;
 
 	priv->xstats.tx_clean[queue]++;
 
+	/* tx_clean is the only consumer of the ring and runs without the TX
+	 * queue lock: it only walks the entries published by the doorbell.
+	 * Pairs with the release in tc956xmac_flush_tx_descriptors.
+	 */
+	tail_tx = smp_load_acquire(&tx_q->tail_tx);
 	entry = tx_q->dirty_tx;
-	while ((entry != tx_q->cur_tx) && (count < budget)) {
+	while ((entry != tail_tx) && (count < budget)) {
 		struct sk_buff *skb = tx_q->tx_skbuff[entry];
+		struct xdp_frame *xdpf = tx_q->xdpf[entry];
 		struct dma_desc *p;
 		int status;
 
@@ -2598,10 +2917,10 @@ static int tc956xmac_tx_clean(struct tc956xmac_priv *priv, int budget, u32 queue
 		if (likely(!(status & tx_not_ls))) {
 			/* ... verify the status error condition */
 			if (unlikely(status & tx_err)) {
-				priv->dev->stats.tx_errors++;
+				tx_errors++;
 				priv->xstats.tx_pkt_errors_n[queue]++;
 			} else {
-				priv->dev->stats.tx_packets++;
+				tx_packets++;
 				priv->xstats.tx_pkt_n[queue]++;
 			}
 #if defined(TX_LOGGING_TRACE)
@@ -2611,7 +2930,16 @@ static int tc956xmac_tx_clean(struct tc956xmac_priv *priv, int budget, u32 queue
 			tc956xmac_get_tx_hwtstamp(priv, p, skb);
 		}
 
-		if (likely(tx_q->tx_skbuff_dma[entry].buf)) {
+		if (tx_q->tx_skbuff_dma[entry].buf_type == TC956XMAC_TXBUF_T_XSK_TX)
+			xsk_frames++;
+
+		/* XDP_TX and AF_XDP buffers stay mapped by their RX owner,
+		 * bounce buffers for the lifetime of the ring.
+		 */
+		if (likely(tx_q->tx_skbuff_dma[entry].buf) &&
+		    tx_q->tx_skbuff_dma[entry].buf_type != TC956XMAC_TXBUF_T_XDP_TX &&
+		    tx_q->tx_skbuff_dma[entry].buf_type != TC956XMAC_TXBUF_T_XSK_TX &&
+		    tx_q->tx_skbuff_dma[entry].buf_type != TC956XMAC_TXBUF_T_BOUNCE) {
 			if (tx_q->tx_skbuff_dma[entry].map_as_page)
 				dma_unmap_page(priv->device,
 					       tx_q->tx_skbuff_dma[entry].buf,
@@ -2632,6 +2960,13 @@ static int tc956xmac_tx_clean(struct tc956xmac_priv *priv, int budget, u32 queue
 		tx_q->tx_skbuff_dma[entry].last_segment = false;
 		tx_q->tx_skbuff_dma[entry].is_jumbo = false;
 
+		if (xdpf) {
+			xdp_return_frame(xdpf);
+			tx_q->xdpf[entry] = NULL;
+		}
+		tx_q->tx_skbuff_dma[entry].buf = 0;
+		tx_q->tx_skbuff_dma[entry].buf_type = TC956XMAC_TXBUF_T_SKB;
+
 		if (likely(skb != NULL)) {
 			pkts_compl++;
 			bytes_compl += skb->len;
@@ -2641,15 +2976,34 @@ static int tc956xmac_tx_clean(struct tc956xmac_priv *priv, int budget, u32 queue
 
 		tc956xmac_release_tx_desc(priv, p, priv->mode);
 
-		entry = TC956XMAC_GET_ENTRY(entry, DMA_TX_SIZE);
+		entry = TC956XMAC_GET_ENTRY(entry, tx_q->dma_tx_size);
+	}
+	/* Hand the cleaned entries back to the xmit path */
+	smp_store_release(&tx_q->dirty_tx, entry);
+
+	u64_stats_update_begin(&tx_q->txq_stats.napi_syncp);
+	tx_q->txq_stats.tx_packets += tx_packets;
+	tx_q->txq_stats.tx_errors += tx_errors;
+	u64_stats_update_end(&tx_q->txq_stats.napi_syncp);
+
+	if (tx_q->xsk_umem) {
+		if (xsk_frames)
+			xsk_umem_complete_tx(tx_q->xsk_umem, xsk_frames);
+
+		if (xsk_umem_uses_need_wakeup(tx_q->xsk_umem))
+			xsk_set_tx_need_wakeup(tx_q->xsk_umem);
 	}
-	tx_q->dirty_tx = entry;
 
 	netdev_tx_completed_queue(netdev_get_tx_queue(priv->dev, queue),
 				  pkts_compl, bytes_compl);
 
+	/* Pairs with the smp_mb() in tc956xmac_tx_maybe_stop: make the new
+	 * dirty_tx visible before looking at the queue state.
+	 */
+	smp_mb();
+
 	if (unlikely(netif_tx_queue_stopped(netdev_get_tx_queue(priv->dev, queue))) &&
-	    tc956xmac_tx_avail(priv, queue) > TC956XMAC_TX_THRESH) {
+	    tc956xmac_tx_avail(priv, queue) > TC956XMAC_TX_THRESH(tx_q)) {
 
 		netif_dbg(priv, tx_done, priv->dev,
 			  "%s: restart transmit\n", __func__);
@@ -2662,10 +3016,8 @@ static int tc956xmac_tx_clean(struct tc956xmac_priv *priv, int budget, u32 queue
 	}
 
 	/* We still have pending packets, let's call for a new scheduling */
-	if (tx_q->dirty_tx != tx_q->cur_tx)
-		mod_timer(&tx_q->txtimer, TC956XMAC_COAL_TIMER(priv->tx_coal_timer));
-
-	__netif_tx_unlock_bh(netdev_get_tx_queue(priv->dev, queue));
+	if (tx_q->dirty_tx != READ_ONCE(tx_q->tail_tx))
+		mod_timer(&tx_q->txtimer, TC956XMAC_COAL_TIMER(tx_q->tx_coal_timer));
 
 	return count;
 }
@@ -2688,6 +3040,7 @@ static void tc956xmac_tx_err(struct tc956xmac_priv *priv, u32 chan)
 	tc956xmac_clear_tx_descriptors(priv, chan);
 	tx_q->dirty_tx = 0;
 	tx_q->cur_tx = 0;
+	tx_q->tail_tx = 0;
 	tx_q->mss = 0;
 	netdev_tx_reset_queue(netdev_get_tx_queue(priv->dev, chan));
 	tc956xmac_init_tx_chan(priv, priv->ioaddr, priv->plat->dma_cfg,
@@ -2819,6 +3172,64 @@ static int tc956xmac_napi_check(struct tc956xmac_priv *priv, u32 chan)
 	return status;
 }
 
+/**
+ * tc956xmac_dma_chan_tx_err - handle Tx DMA errors of a channel
+ * @priv: driver private structure
+ * @chan: channel index
+ * @status: DMA status returned by tc956xmac_napi_check
+ * Description: bumps up the DMA threshold or restarts the Tx path
+ * depending on the reported error.
+ */
+static void tc956xmac_dma_chan_tx_err(struct tc956xmac_priv *priv, u32 chan,
+				      int status)
+{
+	if (unlikely(status & tx_hard_error_bump_tc)) {
+		/* Try to bump up the dma threshold on this failure */
+		if (unlikely(priv->xstats.threshold != SF_DMA_MODE) &&
+		    (tc <= 256)) {
+			tc += 64;
+			if (priv->plat->force_thresh_dma_mode)
+				tc956xmac_set_dma_operation_mode(priv,
+							      tc,
+							      tc,
+							      chan);
+			else
+				tc956xmac_set_dma_operation_mode(priv,
+							    tc,
+							    SF_DMA_MODE,
+							    chan);
+			priv->xstats.threshold = tc;
+		}
+	} else if (unlikely(status == tx_hard_error)) {
+		tc956xmac_chan_err(priv, chan, true, false);
+	}
+
+	if (unlikely(status & dma_fatal_error))
+		tc956xmac_chan_err(priv, chan, true, false);
+}
+
+/**
+ * tc956xmac_dma_chan_rx_err - handle Rx DMA errors of a channel
+ * @priv: driver private structure
+ * @chan: channel index
+ * @status: DMA status returned by tc956xmac_napi_check
+ * Description: restarts the Rx path after a fatal bus error, or when the
+ * channel keeps reporting unavailable buffers without receiving anything.
+ */
+static void tc956xmac_dma_chan_rx_err(struct tc956xmac_priv *priv, u32 chan,
+				      int status)
+{
+	struct tc956xmac_channel *ch = &priv->channel[chan];
+
+	if (unlikely(status & dma_fatal_error)) {
+		tc956xmac_chan_err(priv, chan, false, true);
+	} else if (unlikely(status & rx_buf_unav) &&
+		   ++ch->rbu_events >= TC956XMAC_RBU_STORM) {
+		ch->rbu_events = 0;
+		tc956xmac_chan_err(priv, chan, false, true);
+	}
+}
+
 /**
  * tc956xmac_dma_interrupt - DMA ISR
  * @priv: driver private structure
@@ -2845,28 +3256,11 @@ static void tc956xmac_dma_interrupt(struct tc956xmac_priv *priv)
 	for (chan = 0; chan < channels_to_check; chan++)
 		status[chan] = tc956xmac_napi_check(priv, chan);
 
-	for (chan = 0; chan < tx_channel_count; chan++) {
-		if (unlikely(status[chan] & tx_hard_error_bump_tc)) {
-			/* Try to bump up the dma threshold on this failure */
-			if (unlikely(priv->xstats.threshold != SF_DMA_MODE) &&
-			    (tc <= 256)) {
-				tc += 64;
-				if (priv->plat->force_thresh_dma_mode)
-					tc956xmac_set_dma_operation_mode(priv,
-								      tc,
-								      tc,
-								      chan);
-				else
-					tc956xmac_set_dma_operation_mode(priv,
-								    tc,
-								    SF_DMA_MODE,
-								    chan);
-				priv->xstats.threshold = tc;
-			}
-		} else if (unlikely(status[chan] == tx_hard_error)) {
-			tc956xmac_tx_err(priv, chan);
-		}
-	}
+	for (chan = 0; chan < tx_channel_count; chan++)
+		tc956xmac_dma_chan_tx_err(priv, chan, status[chan]);
+
+	for (chan = 0; chan < rx_channel_count; chan++)
+		tc956xmac_dma_chan_rx_err(priv, chan, status[chan]);
 }
 
 /**
@@ -2977,7 +3371,11 @@ static int tc956xmac_init_dma_engine(struct tc956xmac_priv *priv)
 		tc956xmac_init_rx_chan(priv, priv->ioaddr, priv->plat->dma_cfg, rx_q->dma_rx_phy, chan);
 
 		rx_q->rx_tail_addr = rx_q->dma_rx_phy +
-			    (DMA_RX_SIZE * sizeof(struct dma_desc));
+			    (rx_q->dma_rx_size * sizeof(struct dma_desc));
+		/* Zero-copy rings may start partially filled, or empty */
+		if (rx_q->xsk_umem && rx_q->xsk_armed < rx_q->dma_rx_size)
+			rx_q->rx_tail_addr = rx_q->dma_rx_phy +
+				    (rx_q->dirty_rx * sizeof(struct dma_desc));
 		tc956xmac_set_rx_tail_ptr(priv, priv->ioaddr, rx_q->rx_tail_addr, chan);
 	}
 
@@ -3003,7 +3401,38 @@ static void tc956xmac_tx_timer_arm(struct tc956xmac_priv *priv, u32 queue)
 {
 	struct tc956xmac_tx_queue *tx_q = &priv->tx_queue[queue];
 
-	mod_timer(&tx_q->txtimer, TC956XMAC_COAL_TIMER(priv->tx_coal_timer));
+	mod_timer(&tx_q->txtimer, TC956XMAC_COAL_TIMER(tx_q->tx_coal_timer));
+}
+
+/**
+ * tc956xmac_flush_tx_descriptors - ring the Tx doorbell of a queue
+ * @priv: driver private structure
+ * @queue: TX queue index
+ * Description: moves the tail pointer up to cur_tx so that the DMA fetches
+ * all the descriptors prepared since the last doorbell, and arms the
+ * mitigation timer.
+ */
+static void tc956xmac_flush_tx_descriptors(struct tc956xmac_priv *priv,
+					   u32 queue)
+{
+	struct tc956xmac_tx_queue *tx_q = &priv->tx_queue[queue];
+	int desc_size;
+
+	tc956xmac_enable_dma_transmission(priv, priv->ioaddr);
+
+	if (likely(priv->extend_desc))
+		desc_size = sizeof(struct dma_extended_desc);
+	else if (tx_q->tbs & TC956XMAC_TBS_AVAIL)
+		desc_size = sizeof(struct dma_edesc);
+	else
+		desc_size = sizeof(struct dma_desc);
+
+	/* Publish the descriptors, OWN bits included, to tc956xmac_tx_clean */
+	smp_store_release(&tx_q->tail_tx, tx_q->cur_tx);
+
+	tx_q->tx_tail_addr = tx_q->dma_tx_phy + (tx_q->cur_tx * desc_size);
+	tc956xmac_set_tx_tail_ptr(priv, priv->ioaddr, tx_q->tx_tail_addr, queue);
+	tc956xmac_tx_timer_arm(priv, queue);
 }
 
 /**
@@ -3038,21 +3467,44 @@ static void tc956xmac_tx_timer(struct timer_list *t)
 }
 
 /**
- * tc956xmac_init_coalesce - init mitigation options.
+ * tc956xmac_default_coalesce - default mitigation options.
  * @priv: driver private structure
  * Description:
- * This inits the coalesce parameters: i.e. timer rate,
- * timer handler and default threshold used for enabling the
- * interrupt on completion bit.
+ * This sets the default coalesce parameters of the device and of every
+ * queue: i.e. timer rate, RX watchdog and default threshold used for
+ * enabling the interrupt on completion bit. It is only called at probe so
+ * that the per-queue values set through ethtool survive an ifdown/ifup.
  */
-static void tc956xmac_init_coalesce(struct tc956xmac_priv *priv)
+static void tc956xmac_default_coalesce(struct tc956xmac_priv *priv)
 {
-	u32 tx_channel_count = priv->plat->tx_queues_to_use;
 	u32 chan;
 
 	priv->tx_coal_frames = TC956XMAC_TX_FRAMES;
 	priv->tx_coal_timer = TC956XMAC_COAL_TX_TIMER;
 	priv->rx_coal_frames = TC956XMAC_RX_FRAMES;
+	priv->rx_riwt = DEF_DMA_RIWT;
+
+	for (chan = 0; chan < MTL_MAX_TX_QUEUES; chan++) {
+		priv->tx_queue[chan].tx_coal_frames = priv->tx_coal_frames;
+		priv->tx_queue[chan].tx_coal_timer = priv->tx_coal_timer;
+	}
+
+	for (chan = 0; chan < MTL_MAX_RX_QUEUES; chan++) {
+		priv->rx_queue[chan].rx_coal_frames = priv->rx_coal_frames;
+		priv->rx_queue[chan].rx_riwt = priv->rx_riwt;
+	}
+}
+
+/**
+ * tc956xmac_init_coalesce - init mitigation options.
+ * @priv: driver private structure
+ * Description:
+ * This inits the timer handler used for the TX mitigation.
+ */
+static void tc956xmac_init_coalesce(struct tc956xmac_priv *priv)
+{
+	u32 tx_channel_count = priv->plat->tx_queues_to_use;
+	u32 chan;
 
 	for (chan = 0; chan < tx_channel_count; chan++) {
 		struct tc956xmac_tx_queue *tx_q = &priv->tx_queue[chan];
@@ -3078,7 +3530,7 @@ static void tc956xmac_set_rings_length(struct tc956xmac_priv *priv)
 			continue;
 
 		tc956xmac_set_tx_ring_len(priv, priv->ioaddr,
-				(DMA_TX_SIZE - 1), chan);
+				(priv->tx_queue[chan].dma_tx_size - 1), chan);
 	}
 
 	/* set RX ring length */
@@ -3087,7 +3539,7 @@ static void tc956xmac_set_rings_length(struct tc956xmac_priv *priv)
 			continue;
 
 		tc956xmac_set_rx_ring_len(priv, priv->ioaddr,
-				(DMA_RX_SIZE - 1), chan);
+				(priv->rx_queue[chan].dma_rx_size - 1), chan);
 	}
 }
 
@@ -3143,7 +3595,7 @@ static void tc956xmac_configure_cbs(struct tc956xmac_priv *priv)
  */
 static void tc956xmac_rx_queue_dma_chan_map(struct tc956xmac_priv *priv)
 {
-	u32 rx_queues_count = priv->plat->rx_queues_to_use;
+	u32 rx_queues_count = priv->mtl_rx_queues;
 	u32 queue;
 	u32 chan;
 
@@ -3160,7 +3612,7 @@ static void tc956xmac_rx_queue_dma_chan_map(struct tc956xmac_priv *priv)
  */
 static void tc956xmac_mac_config_rx_queues_prio(struct tc956xmac_priv *priv)
 {
-	u32 rx_queues_count = priv->plat->rx_queues_to_use;
+	u32 rx_queues_count = priv->mtl_rx_queues;
 	u32 queue;
 	u32 prio;
 
@@ -3200,7 +3652,7 @@ static void tc956xmac_mac_config_tx_queues_prio(struct tc956xmac_priv *priv)
  */
 static void tc956xmac_mac_config_rx_queues_routing(struct tc956xmac_priv *priv)
 {
-	u32 rx_queues_count = priv->plat->rx_queues_to_use;
+	u32 rx_queues_count = priv->mtl_rx_queues;
 	u32 queue;
 	u8 packet;
 
@@ -3214,6 +3666,24 @@ static void tc956xmac_mac_config_rx_queues_routing(struct tc956xmac_priv *priv)
 	}
 }
 
+/**
+ * tc956xmac_rss_default_table - spread the RSS table over the host channels
+ * @priv: driver private structure
+ */
+static void tc956xmac_rss_default_table(struct tc956xmac_priv *priv)
+{
+	u32 rss_chan[MTL_MAX_RX_QUEUES];
+	u32 rxq = 0, i;
+
+	for (i = 0; i < priv->plat->rx_queues_to_use; i++) {
+		if (priv->plat->rx_dma_ch_owner[i] == USE_IN_TC956X_SW)
+			rss_chan[rxq++] = i;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(priv->rss.table); i++)
+		priv->rss.table[i] = rxq ? rss_chan[ethtool_rxfh_indir_default(i, rxq)] : 0;
+}
+
 static void tc956xmac_mac_config_rss(struct tc956xmac_priv *priv)
 {
 	if (!priv->dma_cap.rssen || !priv->plat->rss_en) {
@@ -3227,7 +3697,7 @@ static void tc956xmac_mac_config_rss(struct tc956xmac_priv *priv)
 		priv->rss.enable = false;
 #ifdef TC956X_UNSUPPORTED_UNTESTED_FEATURE
 	tc956xmac_rss_configure(priv, priv->hw, &priv->rss,
-			     priv->plat->rx_queues_to_use);
+			     priv->mtl_rx_queues);
 #endif /* TC956X_UNSUPPORTED_UNTESTED_FEATURE */
 }
 
@@ -3238,7 +3708,7 @@ static void tc956xmac_mac_config_rss(struct tc956xmac_priv *priv)
  */
 static void tc956xmac_mtl_configuration(struct tc956xmac_priv *priv)
 {
-	u32 rx_queues_count = priv->plat->rx_queues_to_use;
+	u32 rx_queues_count = priv->mtl_rx_queues;
 	u32 tx_queues_count = priv->plat->tx_queues_to_use;
 
 	if (tx_queues_count > 1)
@@ -3383,6 +3853,12 @@ static int tc956xmac_hw_setup(struct net_device *dev, bool init_ptp)
 	/* Initialize Safety Features */
 	tc956xmac_safety_feat_configuration(priv);
 	ret = tc956xmac_rx_parser_configuration(priv);
+#ifdef TC956X_UNSUPPORTED_UNTESTED_FEATURE
+	/* tc and ethtool ntuple rules take the place of the static table */
+	if (tc956xmac_rxp_has_rules(priv))
+		tc956xmac_rxp_config(priv, priv->hw->pcsr, priv->tc_entries,
+				     priv->tc_entries_max);
+#endif /* TC956X_UNSUPPORTED_UNTESTED_FEATURE */
 
 	ret = tc956xmac_rx_ipc(priv, priv->hw);
 	if (!ret) {
@@ -3421,10 +3897,14 @@ static int tc956xmac_hw_setup(struct net_device *dev, bool init_ptp)
 	priv->tx_lpi_timer = TC956XMAC_DEFAULT_TWT_LS;
 
 	if (priv->use_riwt) {
-		if (!priv->rx_riwt)
-			priv->rx_riwt = DEF_DMA_RIWT;
+		for (chan = 0; chan < rx_cnt; chan++) {
+			if (priv->plat->rx_dma_ch_owner[chan] != USE_IN_TC956X_SW)
+				continue;
 
-		ret = tc956xmac_rx_watchdog(priv, priv->ioaddr, priv->rx_riwt, rx_cnt);
+			tc956xmac_set_rx_watchdog(priv, priv->ioaddr,
+						  priv->rx_queue[chan].rx_riwt,
+						  chan);
+		}
 	}
 
 #ifdef TC956X
@@ -3483,87 +3963,186 @@ static void tc956xmac_hw_teardown(struct net_device *dev)
 	clk_disable_unprepare(priv->plat->clk_ptp_ref);
 }
 
+#ifdef TC956X
 /**
- *  tc956xmac_open - open entry point of the driver
- *  @dev : pointer to the device structure.
- *  Description:
- *  This function is the open entry point of the driver.
- *  Return value:
- *  0 on success and an appropriate (-)ve integer as defined in errno.h
- *  file on failure.
+ *  tc956xmac_msi_intr_chan - per channel Interrupt Service Routine
+ *  @irq: interrupt number.
+ *  @data: pointer to the DMA channel the vector belongs to.
+ *  Description: used in multi vector MSI mode. It only reads the status
+ *  of its own DMA channel and schedules the Tx/Rx NAPI of that channel,
+ *  the MAC, MTL and PHY events stay on vector 0.
  */
-static int tc956xmac_open(struct net_device *dev)
+static irqreturn_t tc956xmac_msi_intr_chan(int irq, void *data)
 {
-	struct tc956xmac_priv *priv = netdev_priv(dev);
-	int bfsize = 0;
-	u32 chan, rd_val;
-	int ret;
+	struct tc956xmac_channel *ch = (struct tc956xmac_channel *)data;
+	struct tc956xmac_priv *priv = ch->priv_data;
+	u32 chan = ch->index;
+	int status;
 
-	if (priv->hw->pcs != TC956XMAC_PCS_RGMII &&
-	    priv->hw->pcs != TC956XMAC_PCS_TBI &&
-	    priv->hw->pcs != TC956XMAC_PCS_RTBI) {
-		ret = tc956xmac_init_phy(dev);
-		if (ret) {
-			netdev_err(priv->dev,
-				   "%s: Cannot attach to PHY (error: %d)\n",
-				   __func__, ret);
-			return ret;
-		}
-	}
+	if (unlikely(test_bit(TC956XMAC_DOWN, &priv->state)))
+		return IRQ_HANDLED;
 
+	status = tc956xmac_napi_check(priv, chan);
+	if (chan < priv->plat->tx_queues_to_use)
+		tc956xmac_dma_chan_tx_err(priv, chan, status);
+	if (chan < priv->plat->rx_queues_to_use)
+		tc956xmac_dma_chan_rx_err(priv, chan, status);
 
-	/* Extra statistics */
-	memset(&priv->xstats, 0, sizeof(struct tc956xmac_extra_stats));
-	priv->xstats.threshold = tc;
+	/* MSI_MSK_CLR, unmask the channel vector */
+	writel(BIT(TC956X_MSI_CH_VECTOR(chan)),
+	       priv->ioaddr + TC956X_MSI_MASK_CLR_OFFSET(priv->port_num));
 
-	bfsize = tc956xmac_set_16kib_bfsize(priv, dev->mtu);
-	if (bfsize < 0)
-		bfsize = 0;
+	return IRQ_HANDLED;
+}
 
-	if (bfsize < BUF_SIZE_16KiB)
-		bfsize = tc956xmac_set_bfsize(dev->mtu, priv->dma_buf_sz);
+/**
+ * tc956xmac_chan_in_use - check whether a DMA channel is owned by the host
+ * @priv: driver private structure
+ * @chan: channel index
+ */
+static bool tc956xmac_chan_in_use(struct tc956xmac_priv *priv, u32 chan)
+{
+	return (chan < priv->plat->tx_queues_to_use &&
+		priv->plat->tx_dma_ch_owner[chan] == USE_IN_TC956X_SW) ||
+	       (chan < priv->plat->rx_queues_to_use &&
+		priv->plat->rx_dma_ch_owner[chan] == USE_IN_TC956X_SW);
+}
 
-	priv->dma_buf_sz = bfsize;
-	buf_sz = bfsize;
+/**
+ * tc956xmac_msi_vec_mask - MSI vectors used by the host
+ * @priv: driver private structure
+ * Description: returns the bitmap of MSIGEN vectors to be unmasked.
+ */
+static u32 tc956xmac_msi_vec_mask(struct tc956xmac_priv *priv)
+{
+	u32 mask = BIT(TC956X_MSI_COMMON_VECTOR);
+	u32 chan;
 
-	priv->rx_copybreak = TC956XMAC_RX_COPYBREAK;
+	if (!priv->msi_multi_vec)
+		return mask;
 
-	/* Earlier check for TBS */
-	for (chan = 0; chan < priv->plat->tx_queues_to_use; chan++) {
-		struct tc956xmac_tx_queue *tx_q = &priv->tx_queue[chan];
-		int tbs_en = priv->plat->tx_queues_cfg[chan].tbs_en;
+	for (chan = 0; chan < TC956XMAC_CH_MAX; chan++) {
+		if (tc956xmac_chan_in_use(priv, chan))
+			mask |= BIT(TC956X_MSI_CH_VECTOR(chan));
+	}
 
-		/* Set TC956XMAC_TBS_EN by default. Later allow tc command to
-		 *enable/disable
-		 */
-		tx_q->tbs |= tbs_en ? TC956XMAC_TBS_AVAIL | TC956XMAC_TBS_EN : 0;
+	return mask;
+}
 
-		if (tc956xmac_enable_tbs(priv, priv->ioaddr, tbs_en, chan))
-			tx_q->tbs &= ~TC956XMAC_TBS_AVAIL;
+/**
+ * tc956xmac_msi_vect_config - route interrupt sources to MSI vectors
+ * @priv: driver private structure
+ * Description: in single vector mode all the sources are mapped to vector 0.
+ * In multi vector mode the Tx and Rx DMA sources of each host channel are
+ * mapped to the vector of that channel.
+ */
+static void tc956xmac_msi_vect_config(struct tc956xmac_priv *priv)
+{
+	u32 vect_set[TC956X_MSI_VECT_SET_CNT] = {0};
+	u32 chan, src, i;
+
+	for (chan = 0; priv->msi_multi_vec && chan < TC956XMAC_CH_MAX; chan++) {
+		if (!tc956xmac_chan_in_use(priv, chan))
+			continue;
+
+		src = MSI_INT_TX_CH0 + chan;
+		vect_set[src / TC956X_MSI_SRC_PER_VECT_SET] |=
+			TC956X_MSI_CH_VECTOR(chan) << TC956X_MSI_SRC_SHIFT(src);
+		src = MSI_INT_RX_CH0 + chan;
+		vect_set[src / TC956X_MSI_SRC_PER_VECT_SET] |=
+			TC956X_MSI_CH_VECTOR(chan) << TC956X_MSI_SRC_SHIFT(src);
 	}
 
-	ret = alloc_dma_desc_resources(priv);
-	if (ret < 0) {
-		netdev_err(priv->dev, "%s: DMA descriptors allocation failed\n",
-			   __func__);
-		goto dma_desc_error;
+	for (i = 0; i < TC956X_MSI_VECT_SET_CNT; i++)
+		writel(vect_set[i], priv->ioaddr +
+		       TC956X_MSI_VECT_SET_OFFSET(priv->port_num, i));
+}
+
+/**
+ * tc956xmac_free_chan_irqs - release the per channel MSI vectors
+ * @priv: driver private structure
+ */
+static void tc956xmac_free_chan_irqs(struct tc956xmac_priv *priv)
+{
+	u32 chan;
+
+	if (!priv->msi_multi_vec)
+		return;
+
+	for (chan = 0; chan < TC956XMAC_CH_MAX; chan++) {
+		struct tc956xmac_channel *ch = &priv->channel[chan];
+
+		if (!ch->irq || !tc956xmac_chan_in_use(priv, chan))
+			continue;
+
+		irq_set_affinity_hint(ch->irq, NULL);
+		free_irq(ch->irq, ch);
 	}
+}
 
-	ret = init_dma_desc_rings(dev, GFP_KERNEL);
-	if (ret < 0) {
-		netdev_err(priv->dev, "%s: DMA descriptors initialization failed\n",
-			   __func__);
-		goto init_error;
+/**
+ * tc956xmac_request_chan_irqs - request the per channel MSI vectors
+ * @priv: driver private structure
+ * Description: every host owned DMA channel gets its own handler, with an
+ * affinity hint spreading the channels over the CPUs of the local node.
+ */
+static int tc956xmac_request_chan_irqs(struct tc956xmac_priv *priv)
+{
+	int node = dev_to_node(priv->device);
+	u32 chan;
+	int ret;
+
+	if (!priv->msi_multi_vec)
+		return 0;
+
+	for (chan = 0; chan < TC956XMAC_CH_MAX; chan++) {
+		struct tc956xmac_channel *ch = &priv->channel[chan];
+
+		if (!tc956xmac_chan_in_use(priv, chan))
+			continue;
+
+		snprintf(ch->irq_name, sizeof(ch->irq_name), "%s-ch%d",
+			 priv->dev->name, chan);
+		ret = request_irq(ch->irq, tc956xmac_msi_intr_chan, 0,
+				  ch->irq_name, ch);
+		if (unlikely(ret < 0)) {
+			netdev_err(priv->dev,
+				   "%s: ERROR: allocating the channel %d IRQ %d (error: %d)\n",
+				   __func__, chan, ch->irq, ret);
+			goto irq_error;
+		}
+		irq_set_affinity_hint(ch->irq,
+				      cpumask_of(cpumask_local_spread(chan, node)));
 	}
 
-	ret = tc956xmac_hw_setup(dev, true);
-	if (ret < 0) {
-		netdev_err(priv->dev, "%s: Hw setup failed\n", __func__);
-		goto init_error;
+	return 0;
+
+irq_error:
+	while (chan-- > 0) {
+		struct tc956xmac_channel *ch = &priv->channel[chan];
+
+		if (!tc956xmac_chan_in_use(priv, chan))
+			continue;
+
+		irq_set_affinity_hint(ch->irq, NULL);
+		free_irq(ch->irq, ch);
 	}
 
+	return ret;
+}
+#endif
 
 #ifdef TC956X
+/**
+ * tc956xmac_msi_config - route and enable the eMAC interrupts
+ * @priv: driver private structure
+ * Description: masks the eMAC interrupts towards the MCU and programs the
+ * MSIGEN block for the channels owned by the host.
+ */
+static void tc956xmac_msi_config(struct tc956xmac_priv *priv)
+{
+	u32 chan, rd_val;
+
 	if (priv->port_num == RM_PF0_ID) {
 		/* mask all eMAC interrupts for MCU */
 		rd_val = readl(priv->ioaddr + INTMCUMASK0);
@@ -3592,26 +4171,16 @@ static int tc956xmac_open(struct net_device *dev)
 
 	/* MSI_OUT_EN: Disable all first */
 	writel(0x00000000, priv->ioaddr + TC956X_MSI_OUT_EN_OFFSET(priv->port_num));
-	/* MSI_MASK_SET: mask all vectors other than vector 0 */
-	writel(0xfffffffe, priv->ioaddr + TC956X_MSI_MASK_SET_OFFSET(priv->port_num));
-	/* MSI_MASK_CLR: unmask vector 0 */
-	writel(0x00000001, priv->ioaddr + TC956X_MSI_MASK_CLR_OFFSET(priv->port_num));
-	/* MSI_VECT_SET0: All INTs mapped to vector 0 */
-	writel(0x00000000, priv->ioaddr + TC956X_MSI_VECT_SET0_OFFSET(priv->port_num));
-	/* MSI_VECT_SET1: All INTs mapped to vector 0 */
-	writel(0x00000000, priv->ioaddr + TC956X_MSI_VECT_SET1_OFFSET(priv->port_num));
-	/* MSI_VECT_SET2: All INTs mapped to vector 0 */
-	writel(0x00000000, priv->ioaddr + TC956X_MSI_VECT_SET2_OFFSET(priv->port_num));
-	/* MSI_VECT_SET3: All INTs mapped to vector 0 */
-	writel(0x00000000, priv->ioaddr + TC956X_MSI_VECT_SET3_OFFSET(priv->port_num));
-	/* MSI_VECT_SET4: All INTs mapped to vector 0 */
-	writel(0x00000000, priv->ioaddr + TC956X_MSI_VECT_SET4_OFFSET(priv->port_num));
-	/* MSI_VECT_SET5: All INTs mapped to vector 0 */
-	writel(0x00000000, priv->ioaddr + TC956X_MSI_VECT_SET5_OFFSET(priv->port_num));
-	/* MSI_VECT_SET6: All INTs mapped to vector 0 */
-	writel(0x00000000, priv->ioaddr + TC956X_MSI_VECT_SET6_OFFSET(priv->port_num));
-	/* MSI_VECT_SET7: All INTs mapped to vector 0 */
-	writel(0x00000000, priv->ioaddr + TC956X_MSI_VECT_SET7_OFFSET(priv->port_num));
+	/* MSI_MASK_SET: mask all vectors other than the ones in use */
+	writel(~tc956xmac_msi_vec_mask(priv),
+	       priv->ioaddr + TC956X_MSI_MASK_SET_OFFSET(priv->port_num));
+	/* MSI_MASK_CLR: unmask vectors in use */
+	writel(tc956xmac_msi_vec_mask(priv),
+	       priv->ioaddr + TC956X_MSI_MASK_CLR_OFFSET(priv->port_num));
+	/* MSI_VECT_SET0..7: DMA channel INTs to their own vector in multi
+	 * vector mode, all other INTs mapped to vector 0
+	 */
+	tc956xmac_msi_vect_config(priv);
 
 	/* Disable MSI for Tx/Rx channels that do not belong to Host */
 	rd_val = 0;
@@ -3628,7 +4197,118 @@ static int tc956xmac_open(struct net_device *dev)
 	/* Disable MAC Event and XPCS interrupt */
 	rd_val = ENABLE_MSI_INTR & (~rd_val);
 	writel(rd_val, priv->ioaddr + TC956X_MSI_OUT_EN_OFFSET(priv->port_num)); /* MSI_OUT_EN: Enable All mac int */
+}
+
+/**
+ * tc956xmac_msi_enable - unmask the MSI vectors in use
+ * @priv: driver private structure
+ */
+static void tc956xmac_msi_enable(struct tc956xmac_priv *priv)
+{
+	u32 rd_val;
+
+	if (readl_poll_timeout_atomic(priv->ioaddr +  TC956X_MSI_EVENT_OFFSET(priv->port_num),
+					rd_val, !(rd_val & 0x1), 100, 10000)) {
+
+		netdev_warn(priv->dev, "MSI Vector not clear. MSI_MASK_CLR = 0x0%x\n",
+				readl(priv->ioaddr +  TC956X_MSI_MASK_CLR_OFFSET(priv->port_num)));
+
+	}
+
+	/* MSI_MASK_CLR: unmask vectors in use */
+	writel(tc956xmac_msi_vec_mask(priv),
+	       priv->ioaddr + TC956X_MSI_MASK_CLR_OFFSET(priv->port_num));
+}
+#endif
+
+/**
+ *  tc956xmac_open - open entry point of the driver
+ *  @dev : pointer to the device structure.
+ *  Description:
+ *  This function is the open entry point of the driver.
+ *  Return value:
+ *  0 on success and an appropriate (-)ve integer as defined in errno.h
+ *  file on failure.
+ */
+static int tc956xmac_open(struct net_device *dev)
+{
+	struct tc956xmac_priv *priv = netdev_priv(dev);
+	int bfsize = 0;
+	u32 chan;
+	int ret;
+
+	if (priv->hw->pcs != TC956XMAC_PCS_RGMII &&
+	    priv->hw->pcs != TC956XMAC_PCS_TBI &&
+	    priv->hw->pcs != TC956XMAC_PCS_RTBI) {
+		ret = tc956xmac_init_phy(dev);
+		if (ret) {
+			netdev_err(priv->dev,
+				   "%s: Cannot attach to PHY (error: %d)\n",
+				   __func__, ret);
+			return ret;
+		}
+	}
+
+
+	/* Extra statistics */
+	memset(&priv->xstats, 0, sizeof(struct tc956xmac_extra_stats));
+	priv->xstats.threshold = tc;
+
+	bfsize = tc956xmac_rx_bfsize(priv, dev->mtu);
+
+	priv->dma_buf_sz = bfsize;
+	buf_sz = bfsize;
+
+	/* RX pages are handed to the stack with build_skb when the headroom,
+	 * the DMA buffer and the skb_shared_info fit in one allocation.
+	 */
+	priv->rx_build_skb = false;
+	if (!priv->sph) {
+		unsigned int headroom = tc956xmac_xdp_is_enabled(priv) ?
+					XDP_PACKET_HEADROOM : NET_SKB_PAD;
+
+		priv->rx_build_skb = SKB_DATA_ALIGN(headroom + bfsize) +
+			SKB_DATA_ALIGN(sizeof(struct skb_shared_info)) <=
+			(PAGE_SIZE << tc956xmac_rx_page_order(priv));
+	}
+
+	/* Earlier check for TBS */
+	for (chan = 0; chan < priv->plat->tx_queues_to_use; chan++) {
+		struct tc956xmac_tx_queue *tx_q = &priv->tx_queue[chan];
+		int tbs_en = priv->plat->tx_queues_cfg[chan].tbs_en;
+
+		/* Set TC956XMAC_TBS_EN by default. Later allow tc command to
+		 *enable/disable
+		 */
+		tx_q->tbs |= tbs_en ? TC956XMAC_TBS_AVAIL | TC956XMAC_TBS_EN : 0;
+
+		if (tc956xmac_enable_tbs(priv, priv->ioaddr, tbs_en, chan))
+			tx_q->tbs &= ~TC956XMAC_TBS_AVAIL;
+	}
+
+	ret = alloc_dma_desc_resources(priv);
+	if (ret < 0) {
+		netdev_err(priv->dev, "%s: DMA descriptors allocation failed\n",
+			   __func__);
+		goto dma_desc_error;
+	}
+
+	ret = init_dma_desc_rings(dev, GFP_KERNEL);
+	if (ret < 0) {
+		netdev_err(priv->dev, "%s: DMA descriptors initialization failed\n",
+			   __func__);
+		goto init_error;
+	}
+
+	ret = tc956xmac_hw_setup(dev, true);
+	if (ret < 0) {
+		netdev_err(priv->dev, "%s: Hw setup failed\n", __func__);
+		goto init_error;
+	}
 
+
+#ifdef TC956X
+	tc956xmac_msi_config(priv);
 #endif
 
 	tc956xmac_init_coalesce(priv);
@@ -3648,6 +4328,14 @@ static int tc956xmac_open(struct net_device *dev)
 		goto irq_error;
 	}
 
+#ifdef TC956X
+	ret = tc956xmac_request_chan_irqs(priv);
+	if (ret < 0) {
+		free_irq(dev->irq, dev);
+		goto irq_error;
+	}
+#endif
+
 #ifndef TC956X
 	/* Request the Wake IRQ in case of another line is used for WoL */
 	if (priv->wol_irq != dev->irq) {
@@ -3678,16 +4366,7 @@ static int tc956xmac_open(struct net_device *dev)
 	tc956xmac_start_all_queues(priv);
 
 #ifdef TC956X
-	if (readl_poll_timeout_atomic(priv->ioaddr +  TC956X_MSI_EVENT_OFFSET(priv->port_num),
-					rd_val, !(rd_val & 0x1), 100, 10000)) {
-
-		netdev_warn(priv->dev, "MSI Vector not clear. MSI_MASK_CLR = 0x0%x\n",
-				readl(priv->ioaddr +  TC956X_MSI_MASK_CLR_OFFSET(priv->port_num)));
-
-	}
-
-	/* MSI_MASK_CLR: unmask vector 0 */
-	writel(0x00000001, priv->ioaddr + TC956X_MSI_MASK_CLR_OFFSET(priv->port_num));
+	tc956xmac_msi_enable(priv);
 #endif
 
 	return 0;
@@ -3744,6 +4423,9 @@ static int tc956xmac_release(struct net_device *dev)
 
 	/* Free the IRQ lines */
 	free_irq(dev->irq, dev);
+#ifdef TC956X
+	tc956xmac_free_chan_irqs(priv);
+#endif
 
 #ifndef TC956X
 	if (priv->wol_irq != dev->irq)
@@ -3794,7 +4476,7 @@ static bool tc956xmac_vlan_insert(struct tc956xmac_priv *priv, struct sk_buff *s
 		return false;
 
 	tc956xmac_set_tx_owner(priv, p);
-	tx_q->cur_tx = TC956XMAC_GET_ENTRY(tx_q->cur_tx, DMA_TX_SIZE);
+	tx_q->cur_tx = TC956XMAC_GET_ENTRY(tx_q->cur_tx, tx_q->dma_tx_size);
 	return true;
 }
 
@@ -3822,7 +4504,7 @@ static void tc956xmac_tso_allocator(struct tc956xmac_priv *priv, dma_addr_t des,
 	while (tmp_len > 0) {
 		dma_addr_t curr_addr;
 
-		tx_q->cur_tx = TC956XMAC_GET_ENTRY(tx_q->cur_tx, DMA_TX_SIZE);
+		tx_q->cur_tx = TC956XMAC_GET_ENTRY(tx_q->cur_tx, tx_q->dma_tx_size);
 		WARN_ON(tx_q->tx_skbuff[tx_q->cur_tx]);
 
 		if (tx_q->tbs & TC956XMAC_TBS_AVAIL)
@@ -3881,7 +4563,7 @@ static netdev_tx_t tc956xmac_tso_xmit(struct sk_buff *skb, struct net_device *de
 {
 	struct dma_desc *desc, *first, *mss_desc = NULL;
 	struct tc956xmac_priv *priv = netdev_priv(dev);
-	int desc_size, tmp_pay_len = 0, first_tx;
+	int tmp_pay_len = 0, first_tx;
 	int nfrags = skb_shinfo(skb)->nr_frags;
 	u32 queue = skb_get_queue_mapping(skb);
 	unsigned int first_entry, tx_packets;
@@ -3914,6 +4596,8 @@ static netdev_tx_t tc956xmac_tso_xmit(struct sk_buff *skb, struct net_device *de
 			netdev_err(priv->dev,
 				   "%s: Tx Ring full when queue awake\n",
 				   __func__);
+			/* Kick the frames of a deferred burst, if any */
+			tc956xmac_flush_tx_descriptors(priv, queue);
 		}
 		return NETDEV_TX_BUSY;
 	}
@@ -3931,7 +4615,7 @@ static netdev_tx_t tc956xmac_tso_xmit(struct sk_buff *skb, struct net_device *de
 
 		tc956xmac_set_mss(priv, mss_desc, mss);
 		tx_q->mss = mss;
-		tx_q->cur_tx = TC956XMAC_GET_ENTRY(tx_q->cur_tx, DMA_TX_SIZE);
+		tx_q->cur_tx = TC956XMAC_GET_ENTRY(tx_q->cur_tx, tx_q->dma_tx_size);
 		WARN_ON(tx_q->tx_skbuff[tx_q->cur_tx]);
 	}
 
@@ -4019,11 +4703,11 @@ static netdev_tx_t tc956xmac_tso_xmit(struct sk_buff *skb, struct net_device *de
 
 	if ((skb_shinfo(skb)->tx_flags & SKBTX_HW_TSTAMP) && priv->hwts_tx_en)
 		set_ic = true;
-	else if (!priv->tx_coal_frames)
+	else if (!tx_q->tx_coal_frames)
 		set_ic = false;
-	else if (tx_packets > priv->tx_coal_frames)
+	else if (tx_packets > tx_q->tx_coal_frames)
 		set_ic = true;
-	else if ((tx_q->tx_count_frames % priv->tx_coal_frames) < tx_packets)
+	else if ((tx_q->tx_count_frames % tx_q->tx_coal_frames) < tx_packets)
 		set_ic = true;
 	else
 		set_ic = false;
@@ -4044,15 +4728,13 @@ static netdev_tx_t tc956xmac_tso_xmit(struct sk_buff *skb, struct net_device *de
 	 * ndo_start_xmit will fill this descriptor the next time it's
 	 * called and tc956xmac_tx_clean may clean up to this descriptor.
 	 */
-	tx_q->cur_tx = TC956XMAC_GET_ENTRY(tx_q->cur_tx, DMA_TX_SIZE);
+	tx_q->cur_tx = TC956XMAC_GET_ENTRY(tx_q->cur_tx, tx_q->dma_tx_size);
 
-	if (unlikely(tc956xmac_tx_avail(priv, queue) <= (MAX_SKB_FRAGS + 1))) {
-		netif_dbg(priv, hw, priv->dev, "%s: stop transmitted packets\n",
-			  __func__);
-		netif_tx_stop_queue(netdev_get_tx_queue(priv->dev, queue));
-	}
+	tc956xmac_tx_maybe_stop(priv, queue, MAX_SKB_FRAGS + 1);
 
-	dev->stats.tx_bytes += skb->len;
+	u64_stats_update_begin(&tx_q->txq_stats.syncp);
+	tx_q->txq_stats.tx_bytes += skb->len;
+	u64_stats_update_end(&tx_q->txq_stats.syncp);
 	priv->xstats.tx_tso_frames[queue]++;
 	priv->xstats.tx_tso_nfrags[queue] += nfrags;
 
@@ -4100,23 +4782,24 @@ static netdev_tx_t tc956xmac_tso_xmit(struct sk_buff *skb, struct net_device *de
 		print_pkt(skb->data, skb_headlen(skb));
 	}
 
-	netdev_tx_sent_queue(netdev_get_tx_queue(dev, queue), skb->len);
-
-	if (tx_q->tbs & TC956XMAC_TBS_AVAIL)
-		desc_size = sizeof(struct dma_edesc);
-	else
-		desc_size = sizeof(struct dma_desc);
-
-	tx_q->tx_tail_addr = tx_q->dma_tx_phy + (tx_q->cur_tx * desc_size);
-	tc956xmac_set_tx_tail_ptr(priv, priv->ioaddr, tx_q->tx_tail_addr, queue);
-	tc956xmac_tx_timer_arm(priv, queue);
+	/* Defer the doorbell while the stack has more frames for this queue,
+	 * it is rung at the end of the burst or when the queue is stopped.
+	 */
+	if (__netdev_tx_sent_queue(netdev_get_tx_queue(dev, queue), skb->len,
+				   netdev_xmit_more()))
+		tc956xmac_flush_tx_descriptors(priv, queue);
 
 	return NETDEV_TX_OK;
 
 dma_map_err:
 	dev_err(priv->device, "Tx dma map failed\n");
 	dev_kfree_skb(skb);
-	priv->dev->stats.tx_dropped++;
+	u64_stats_update_begin(&tx_q->txq_stats.syncp);
+	tx_q->txq_stats.tx_dropped++;
+	u64_stats_update_end(&tx_q->txq_stats.syncp);
+	/* Do not leave frames of a deferred burst behind the tail pointer */
+	if (!netdev_xmit_more())
+		tc956xmac_flush_tx_descriptors(priv, queue);
 	return NETDEV_TX_OK;
 }
 
@@ -4138,10 +4821,10 @@ static netdev_tx_t tc956xmac_xmit(struct sk_buff *skb, struct net_device *dev)
 	int nfrags = skb_shinfo(skb)->nr_frags;
 	int gso = skb_shinfo(skb)->gso_type;
 	struct dma_edesc *tbs_desc = NULL;
-	int entry, desc_size, first_tx;
+	int entry, first_tx;
 	struct dma_desc *desc, *first;
 	struct tc956xmac_tx_queue *tx_q;
-	bool has_vlan, set_ic;
+	bool has_vlan, set_ic, bounce;
 	dma_addr_t des;
 	u64 ns = 0;
 	u32 ts_low, ts_high;
@@ -4159,7 +4842,8 @@ static netdev_tx_t tc956xmac_xmit(struct sk_buff *skb, struct net_device *dev)
 		KPRINT_DEBUG1("XMIT TSO IF\n");
 		if (gso & (SKB_GSO_TCPV4 | SKB_GSO_TCPV6))
 			return tc956xmac_tso_xmit(skb, dev);
-		if (priv->plat->has_gmac4 && (gso & SKB_GSO_UDP_L4))
+		if ((priv->plat->has_gmac4 || priv->plat->has_xgmac) &&
+		    (gso & SKB_GSO_UDP_L4))
 			return tc956xmac_tso_xmit(skb, dev);
 	}
 	KPRINT_DEBUG1("XMIT Normal\n");
@@ -4172,6 +4856,8 @@ static netdev_tx_t tc956xmac_xmit(struct sk_buff *skb, struct net_device *dev)
 			netdev_err(priv->dev,
 				   "%s: Tx Ring full when queue awake\n",
 				   __func__);
+			/* Kick the frames of a deferred burst, if any */
+			tc956xmac_flush_tx_descriptors(priv, queue);
 		}
 		return NETDEV_TX_BUSY;
 	}
@@ -4186,7 +4872,7 @@ static netdev_tx_t tc956xmac_xmit(struct sk_buff *skb, struct net_device *dev)
 		ts_low = (u32)ns;
 		ts_high = (u32)(ns >> 32);
 		tc956xmac_set_desc_ostc(priv, desc, ts_high, ts_low);
-		tx_q->cur_tx = TC956XMAC_GET_ENTRY(tx_q->cur_tx, DMA_TX_SIZE);
+		tx_q->cur_tx = TC956XMAC_GET_ENTRY(tx_q->cur_tx, tx_q->dma_tx_size);
 		WARN_ON(tx_q->tx_skbuff[tx_q->cur_tx]);
 	}
 
@@ -4227,12 +4913,21 @@ static netdev_tx_t tc956xmac_xmit(struct sk_buff *skb, struct net_device *dev)
 			goto dma_map_err;
 	}
 
+	/* Small frames, fragments included, are copied into the pre-mapped
+	 * buffer of the first descriptor instead of being mapped.
+	 */
+	bounce = !is_jumbo && skb->len <= priv->tx_copybreak;
+	if (bounce) {
+		nopaged_len = skb->len;
+		nfrags = 0;
+	}
+
 	for (i = 0; i < nfrags; i++) {
 		const skb_frag_t *frag = &skb_shinfo(skb)->frags[i];
 		int len = skb_frag_size(frag);
 		bool last_segment = (i == (nfrags - 1));
 
-		entry = TC956XMAC_GET_ENTRY(entry, DMA_TX_SIZE);
+		entry = TC956XMAC_GET_ENTRY(entry, tx_q->dma_tx_size);
 		WARN_ON(tx_q->tx_skbuff[entry]);
 
 		if (likely(priv->extend_desc))
@@ -4274,11 +4969,11 @@ static netdev_tx_t tc956xmac_xmit(struct sk_buff *skb, struct net_device *dev)
 
 	if ((skb_shinfo(skb)->tx_flags & SKBTX_HW_TSTAMP) && priv->hwts_tx_en)
 		set_ic = true;
-	else if (!priv->tx_coal_frames)
+	else if (!tx_q->tx_coal_frames)
 		set_ic = false;
-	else if (tx_packets > priv->tx_coal_frames)
+	else if (tx_packets > tx_q->tx_coal_frames)
 		set_ic = true;
-	else if ((tx_q->tx_count_frames % priv->tx_coal_frames) < tx_packets)
+	else if ((tx_q->tx_count_frames % tx_q->tx_coal_frames) < tx_packets)
 		set_ic = true;
 	else
 		set_ic = false;
@@ -4301,7 +4996,7 @@ static netdev_tx_t tc956xmac_xmit(struct sk_buff *skb, struct net_device *dev)
 	 * ndo_start_xmit will fill this descriptor the next time it's
 	 * called and tc956xmac_tx_clean may clean up to this descriptor.
 	 */
-	entry = TC956XMAC_GET_ENTRY(entry, DMA_TX_SIZE);
+	entry = TC956XMAC_GET_ENTRY(entry, tx_q->dma_tx_size);
 	tx_q->cur_tx = entry;
 
 	if (netif_msg_pktdata(priv)) {
@@ -4314,13 +5009,11 @@ static netdev_tx_t tc956xmac_xmit(struct sk_buff *skb, struct net_device *dev)
 		print_pkt(skb->data, skb->len);
 	}
 
-	if (unlikely(tc956xmac_tx_avail(priv, queue) <= (MAX_SKB_FRAGS + 1))) {
-		netif_dbg(priv, hw, priv->dev, "%s: stop transmitted packets\n",
-			  __func__);
-		netif_tx_stop_queue(netdev_get_tx_queue(priv->dev, queue));
-	}
+	tc956xmac_tx_maybe_stop(priv, queue, MAX_SKB_FRAGS + 1);
 
-	dev->stats.tx_bytes += skb->len;
+	u64_stats_update_begin(&tx_q->txq_stats.syncp);
+	tx_q->txq_stats.tx_bytes += skb->len;
+	u64_stats_update_end(&tx_q->txq_stats.syncp);
 
 	if (priv->sarc_type)
 		tc956xmac_set_desc_sarc(priv, first, priv->sarc_type);
@@ -4334,10 +5027,19 @@ static netdev_tx_t tc956xmac_xmit(struct sk_buff *skb, struct net_device *dev)
 	if (likely(!is_jumbo)) {
 		bool last_segment = (nfrags == 0);
 
-		des = dma_map_single(priv->device, skb->data,
-				     nopaged_len, DMA_TO_DEVICE);
-		if (dma_mapping_error(priv->device, des))
-			goto dma_map_err;
+		if (bounce) {
+			unsigned int off = first_entry * TC956XMAC_TX_BOUNCE_SZ;
+
+			skb_copy_bits(skb, 0, tx_q->tx_bounce + off, skb->len);
+			des = tx_q->tx_bounce_dma + off;
+			tx_q->tx_skbuff_dma[first_entry].buf_type =
+				TC956XMAC_TXBUF_T_BOUNCE;
+		} else {
+			des = dma_map_single(priv->device, skb->data,
+					     nopaged_len, DMA_TO_DEVICE);
+			if (dma_mapping_error(priv->device, des))
+				goto dma_map_err;
+		}
 
 		tx_q->tx_skbuff_dma[first_entry].buf = des;
 
@@ -4433,27 +5135,24 @@ static netdev_tx_t tc956xmac_xmit(struct sk_buff *skb, struct net_device *dev)
 	 */
 	wmb();
 
-	netdev_tx_sent_queue(netdev_get_tx_queue(dev, queue), skb->len);
+	/* Defer the doorbell while the stack has more frames for this queue,
+	 * it is rung at the end of the burst or when the queue is stopped.
+	 */
+	if (__netdev_tx_sent_queue(netdev_get_tx_queue(dev, queue), skb->len,
+				   netdev_xmit_more()))
+		tc956xmac_flush_tx_descriptors(priv, queue);
 
-	tc956xmac_enable_dma_transmission(priv, priv->ioaddr);
-
-	if (likely(priv->extend_desc))
-		desc_size = sizeof(struct dma_extended_desc);
-	else if (tx_q->tbs & TC956XMAC_TBS_AVAIL)
-		desc_size = sizeof(struct dma_edesc);
-	else
-		desc_size = sizeof(struct dma_desc);
-
-	tx_q->tx_tail_addr = tx_q->dma_tx_phy + (tx_q->cur_tx * desc_size);
-	tc956xmac_set_tx_tail_ptr(priv, priv->ioaddr, tx_q->tx_tail_addr, queue);
-	tc956xmac_tx_timer_arm(priv, queue);
-
-	return NETDEV_TX_OK;
+	return NETDEV_TX_OK;
 
 dma_map_err:
 	netdev_err(priv->dev, "Tx DMA map failed\n");
 	dev_kfree_skb(skb);
-	priv->dev->stats.tx_dropped++;
+	u64_stats_update_begin(&tx_q->txq_stats.syncp);
+	tx_q->txq_stats.tx_dropped++;
+	u64_stats_update_end(&tx_q->txq_stats.syncp);
+	/* Do not leave frames of a deferred burst behind the tail pointer */
+	if (!netdev_xmit_more())
+		tc956xmac_flush_tx_descriptors(priv, queue);
 	return NETDEV_TX_OK;
 }
 
@@ -4481,13 +5180,33 @@ static void tc956xmac_rx_vlan(struct net_device *dev, struct sk_buff *skb)
 #ifdef TC956X_UNSUPPORTED_UNTESTED_FEATURE
 static inline int tc956xmac_rx_threshold_count(struct tc956xmac_rx_queue *rx_q)
 {
-	if (rx_q->rx_zeroc_thresh < TC956XMAC_RX_THRESH)
+	if (rx_q->rx_zeroc_thresh < TC956XMAC_RX_THRESH(rx_q))
 		return 0;
 
 	return 1;
 }
 #endif /* TC956X_UNSUPPORTED_UNTESTED_FEATURE */
 
+/**
+ * tc956xmac_rxq_stats_add - account a NAPI run in the RX queue counters
+ * @rx_q: RX queue
+ * @packets: received frames
+ * @bytes: received bytes
+ * @dropped: frames dropped by the driver
+ * @errors: frames reported in error by the DMA
+ */
+static void tc956xmac_rxq_stats_add(struct tc956xmac_rx_queue *rx_q,
+				    unsigned int packets, u64 bytes,
+				    unsigned int dropped, unsigned int errors)
+{
+	u64_stats_update_begin(&rx_q->rxq_stats.syncp);
+	rx_q->rxq_stats.rx_packets += packets;
+	rx_q->rxq_stats.rx_bytes += bytes;
+	rx_q->rxq_stats.rx_dropped += dropped;
+	rx_q->rxq_stats.rx_errors += errors;
+	u64_stats_update_end(&rx_q->rxq_stats.syncp);
+}
+
 /**
  * tc956xmac_rx_refill - refill used skb preallocated buffers
  * @priv: driver private structure
@@ -4501,7 +5220,7 @@ static inline void tc956xmac_rx_refill(struct tc956xmac_priv *priv, u32 queue)
 	int len, dirty = tc956xmac_rx_dirty(priv, queue);
 	unsigned int entry = rx_q->dirty_rx;
 
-	len = DIV_ROUND_UP(priv->dma_buf_sz, PAGE_SIZE) * PAGE_SIZE;
+	len = DIV_ROUND_UP(rx_q->dma_buf_sz, PAGE_SIZE) * PAGE_SIZE;
 
 	while (dirty-- > 0) {
 		struct tc956xmac_rx_buffer *buf = &rx_q->buf_pool[entry];
@@ -4527,7 +5246,7 @@ static inline void tc956xmac_rx_refill(struct tc956xmac_priv *priv, u32 queue)
 			buf->sec_addr = page_pool_get_dma_addr(buf->sec_page);
 
 			dma_sync_single_for_device(priv->device, buf->sec_addr,
-						   len, DMA_FROM_DEVICE);
+						   len, tc956xmac_rx_dma_dir(priv));
 		}
 
 		buf->addr = page_pool_get_dma_addr(buf->page);
@@ -4536,26 +5255,19 @@ static inline void tc956xmac_rx_refill(struct tc956xmac_priv *priv, u32 queue)
 		 * data.
 		 */
 		dma_sync_single_for_device(priv->device, buf->addr, len,
-					   DMA_FROM_DEVICE);
+					   tc956xmac_rx_dma_dir(priv));
 
-		tc956xmac_set_desc_addr(priv, p, buf->addr);
+		tc956xmac_set_desc_addr(priv, p, buf->addr +
+					tc956xmac_rx_offset(priv));
 		tc956xmac_set_desc_sec_addr(priv, p, buf->sec_addr);
 		tc956xmac_refill_desc3(priv, rx_q, p);
 
-		rx_q->rx_count_frames++;
-		rx_q->rx_count_frames += priv->rx_coal_frames;
-		if (rx_q->rx_count_frames > priv->rx_coal_frames)
-			rx_q->rx_count_frames = 0;
-
-		use_rx_wd = !priv->rx_coal_frames;
-		use_rx_wd |= rx_q->rx_count_frames > 0;
-		if (!priv->use_riwt)
-			use_rx_wd = false;
+		use_rx_wd = tc956xmac_rx_use_wd(priv, rx_q);
 
 		dma_wmb();
 		tc956xmac_set_rx_owner(priv, p, use_rx_wd);
 
-		entry = TC956XMAC_GET_ENTRY(entry, DMA_RX_SIZE);
+		entry = TC956XMAC_GET_ENTRY(entry, rx_q->dma_rx_size);
 	}
 	rx_q->dirty_rx = entry;
 	rx_q->rx_tail_addr = rx_q->dma_rx_phy +
@@ -4564,6 +5276,7 @@ static inline void tc956xmac_rx_refill(struct tc956xmac_priv *priv, u32 queue)
 }
 
 static unsigned int tc956xmac_rx_buf1_len(struct tc956xmac_priv *priv,
+				       struct tc956xmac_rx_queue *rx_q,
 				       struct dma_desc *p,
 				       int status, unsigned int len)
 {
@@ -4581,17 +5294,29 @@ static unsigned int tc956xmac_rx_buf1_len(struct tc956xmac_priv *priv,
 		return hlen;
 	}
 
-	/* First descriptor, not last descriptor and not split header */
+	/* Not last descriptor and not split header */
 	if (status & rx_not_ls)
-		return priv->dma_buf_sz;
+		return rx_q->dma_buf_sz;
 
 	plen = tc956xmac_get_rx_frame_len(priv, p, coe);
 
+	/* Last descriptor of a multi descriptor frame, the frame length
+	 * covers the previous buffers too
+	 */
+	if (len) {
+		if (unlikely(plen < len || plen - len > rx_q->dma_buf_sz)) {
+			priv->xstats.rx_length++;
+			return plen < len ? 0 : rx_q->dma_buf_sz;
+		}
+		return plen - len;
+	}
+
 	/* First descriptor and last descriptor and not split header */
-	return min_t(unsigned int, priv->dma_buf_sz, plen);
+	return min_t(unsigned int, rx_q->dma_buf_sz, plen);
 }
 
 static unsigned int tc956xmac_rx_buf2_len(struct tc956xmac_priv *priv,
+				       struct tc956xmac_rx_queue *rx_q,
 				       struct dma_desc *p,
 				       int status, unsigned int len)
 {
@@ -4604,7 +5329,7 @@ static unsigned int tc956xmac_rx_buf2_len(struct tc956xmac_priv *priv,
 
 	/* Not last descriptor */
 	if (status & rx_not_ls)
-		return priv->dma_buf_sz;
+		return rx_q->dma_buf_sz;
 
 	plen = tc956xmac_get_rx_frame_len(priv, p, coe);
 
@@ -4612,6 +5337,235 @@ static unsigned int tc956xmac_rx_buf2_len(struct tc956xmac_priv *priv,
 	return plen - len;
 }
 
+/**
+ * tc956xmac_xdp_get_tx_queue - TX queue used to send XDP frames
+ * @priv: driver private structure
+ * @cpu: current CPU
+ * Description: spreads the XDP transmission over the host owned TX queues.
+ */
+static u32 tc956xmac_xdp_get_tx_queue(struct tc956xmac_priv *priv, int cpu)
+{
+	u32 tx_cnt = priv->plat->tx_queues_to_use;
+	u32 queue = (u32)cpu % tx_cnt;
+	u32 i;
+
+	for (i = 0; i < tx_cnt; i++) {
+		if (priv->plat->tx_dma_ch_owner[queue] == USE_IN_TC956X_SW)
+			return queue;
+		queue = (queue + 1) % tx_cnt;
+	}
+
+	return HOST_BEST_EFF_CH;
+}
+
+/**
+ * tc956xmac_xdp_fill_desc - post one XDP buffer on a TX ring
+ * @priv: driver private structure
+ * @queue: TX queue index
+ * @dma_addr: DMA address of the frame
+ * @len: frame length
+ * @buf_type: owner of the buffer, tells tx_clean how to release it
+ * Description: must be called with the TX queue lock held and after checking
+ * that a descriptor is available.
+ */
+static void tc956xmac_xdp_fill_desc(struct tc956xmac_priv *priv, u32 queue,
+				    dma_addr_t dma_addr, unsigned int len,
+				    enum tc956xmac_txbuf_type buf_type)
+{
+	struct tc956xmac_tx_queue *tx_q = &priv->tx_queue[queue];
+	unsigned int entry = tx_q->cur_tx;
+	struct dma_desc *desc;
+
+	if (likely(priv->extend_desc))
+		desc = (struct dma_desc *)(tx_q->dma_etx + entry);
+	else if (tx_q->tbs & TC956XMAC_TBS_AVAIL)
+		desc = &tx_q->dma_entx[entry].basic;
+	else
+		desc = tx_q->dma_tx + entry;
+
+	tx_q->tx_skbuff_dma[entry].buf = dma_addr;
+	tx_q->tx_skbuff_dma[entry].map_as_page = false;
+	tx_q->tx_skbuff_dma[entry].len = len;
+	tx_q->tx_skbuff_dma[entry].last_segment = true;
+	tx_q->tx_skbuff_dma[entry].is_jumbo = false;
+	tx_q->tx_skbuff_dma[entry].buf_type = buf_type;
+
+	if (tx_q->tbs & TC956XMAC_TBS_AVAIL)
+		tc956xmac_set_desc_tbs(priv, &tx_q->dma_entx[entry], 0, 0, false);
+
+	tc956xmac_set_desc_addr(priv, desc, dma_addr);
+	tc956xmac_prepare_tx_desc(priv, desc, 1, len, false,
+				  priv->tx_crc_pad_state, priv->mode, 0, true,
+				  len);
+
+	tx_q->tx_count_frames++;
+	if (tx_q->tx_coal_frames &&
+	    !(tx_q->tx_count_frames % tx_q->tx_coal_frames)) {
+		tx_q->tx_count_frames = 0;
+		tc956xmac_set_tx_ic(priv, desc);
+		priv->xstats.tx_set_ic_bit++;
+	}
+
+	dma_wmb();
+	tc956xmac_set_tx_owner(priv, desc);
+
+	u64_stats_update_begin(&tx_q->txq_stats.syncp);
+	tx_q->txq_stats.tx_bytes += len;
+	u64_stats_update_end(&tx_q->txq_stats.syncp);
+	tx_q->cur_tx = TC956XMAC_GET_ENTRY(entry, tx_q->dma_tx_size);
+}
+
+/**
+ * tc956xmac_xdp_xmit_xdpf - queue one XDP frame on a TX ring
+ * @priv: driver private structure
+ * @queue: TX queue index
+ * @xdpf: frame to be sent
+ * @dma_map: true for frames not backed by the RX page_pool
+ * Description: must be called with the TX queue lock held. The doorbell is
+ * left to the caller so that a whole burst is kicked at once.
+ */
+static int tc956xmac_xdp_xmit_xdpf(struct tc956xmac_priv *priv, u32 queue,
+				   struct xdp_frame *xdpf, bool dma_map)
+{
+	struct tc956xmac_tx_queue *tx_q = &priv->tx_queue[queue];
+	enum tc956xmac_txbuf_type buf_type;
+	dma_addr_t dma_addr;
+
+	/* Keep room for the stack, XDP must not starve the regular traffic */
+	if (tc956xmac_tx_avail(priv, queue) < TC956XMAC_TX_THRESH(tx_q))
+		return TC956XMAC_XDP_CONSUMED;
+
+	if (dma_map) {
+		dma_addr = dma_map_single(priv->device, xdpf->data,
+					  xdpf->len, DMA_TO_DEVICE);
+		if (dma_mapping_error(priv->device, dma_addr))
+			return TC956XMAC_XDP_CONSUMED;
+
+		buf_type = TC956XMAC_TXBUF_T_XDP_NDO;
+	} else {
+		struct page *page = virt_to_page(xdpf->data);
+
+		/* The frame lives in a page of the RX page_pool */
+		dma_addr = page_pool_get_dma_addr(page) + sizeof(*xdpf) +
+			   xdpf->headroom;
+		dma_sync_single_for_device(priv->device, dma_addr, xdpf->len,
+					   DMA_BIDIRECTIONAL);
+
+		buf_type = TC956XMAC_TXBUF_T_XDP_TX;
+	}
+
+	tx_q->xdpf[tx_q->cur_tx] = xdpf;
+	tc956xmac_xdp_fill_desc(priv, queue, dma_addr, xdpf->len, buf_type);
+
+	return TC956XMAC_XDP_TX;
+}
+
+/**
+ * tc956xmac_xdp_xmit_frame - send an XDP frame from the RX path
+ * @priv: driver private structure
+ * @xdpf: frame to be sent
+ * @dma_map: true for frames not backed by the RX page_pool
+ */
+static int tc956xmac_xdp_xmit_frame(struct tc956xmac_priv *priv,
+				    struct xdp_frame *xdpf, bool dma_map)
+{
+	int cpu = smp_processor_id();
+	struct netdev_queue *nq;
+	u32 queue;
+	int res;
+
+	queue = tc956xmac_xdp_get_tx_queue(priv, cpu);
+	nq = netdev_get_tx_queue(priv->dev, queue);
+
+	__netif_tx_lock(nq, cpu);
+	/* Avoids TX time-out as we are sharing with slow path */
+	txq_trans_update(nq);
+	res = tc956xmac_xdp_xmit_xdpf(priv, queue, xdpf, dma_map);
+	__netif_tx_unlock(nq);
+
+	return res;
+}
+
+/**
+ * tc956xmac_xdp_xmit_back - XDP_TX action
+ * @priv: driver private structure
+ * @xdp: buffer returned by the XDP program
+ */
+static int tc956xmac_xdp_xmit_back(struct tc956xmac_priv *priv,
+				   struct xdp_buff *xdp)
+{
+	struct xdp_frame *xdpf = convert_to_xdp_frame(xdp);
+
+	if (unlikely(!xdpf))
+		return TC956XMAC_XDP_CONSUMED;
+
+	return tc956xmac_xdp_xmit_frame(priv, xdpf, false);
+}
+
+/**
+ * tc956xmac_xdp_run_prog - run the XDP program on a received buffer
+ * @priv: driver private structure
+ * @prog: XDP program attached to the device
+ * @xdp: buffer holding the received frame
+ * Description: returns one of the TC956XMAC_XDP_* verdicts.
+ */
+static int tc956xmac_xdp_run_prog(struct tc956xmac_priv *priv,
+				  struct bpf_prog *prog, struct xdp_buff *xdp)
+{
+	u32 act;
+	int res;
+
+	act = bpf_prog_run_xdp(prog, xdp);
+	switch (act) {
+	case XDP_PASS:
+		res = TC956XMAC_XDP_PASS;
+		break;
+	case XDP_TX:
+		res = tc956xmac_xdp_xmit_back(priv, xdp);
+		break;
+	case XDP_REDIRECT:
+		if (xdp_do_redirect(priv->dev, xdp, prog) < 0)
+			res = TC956XMAC_XDP_CONSUMED;
+		else
+			res = TC956XMAC_XDP_REDIRECT;
+		break;
+	default:
+		bpf_warn_invalid_xdp_action(act);
+		/* fall through */
+	case XDP_ABORTED:
+		trace_xdp_exception(priv->dev, prog, act);
+		/* fall through */
+	case XDP_DROP:
+		res = TC956XMAC_XDP_CONSUMED;
+		break;
+	}
+
+	return res;
+}
+
+/**
+ * tc956xmac_finalize_xdp_rx - flush the work queued by the XDP program
+ * @priv: driver private structure
+ * @xdp_status: OR of the verdicts seen in this NAPI run
+ */
+static void tc956xmac_finalize_xdp_rx(struct tc956xmac_priv *priv,
+				      int xdp_status)
+{
+	int cpu = smp_processor_id();
+
+	if (xdp_status & TC956XMAC_XDP_TX) {
+		u32 queue = tc956xmac_xdp_get_tx_queue(priv, cpu);
+		struct netdev_queue *nq = netdev_get_tx_queue(priv->dev, queue);
+
+		__netif_tx_lock(nq, cpu);
+		tc956xmac_flush_tx_descriptors(priv, queue);
+		__netif_tx_unlock(nq);
+	}
+
+	if (xdp_status & TC956XMAC_XDP_REDIRECT)
+		xdp_do_flush_map();
+}
+
 /**
  * tc956xmac_rx - manage the receive process
  * @priv: driver private structure
@@ -4625,9 +5579,13 @@ static int tc956xmac_rx(struct tc956xmac_priv *priv, int limit, u32 queue)
 	struct tc956xmac_rx_queue *rx_q = &priv->rx_queue[queue];
 	struct tc956xmac_channel *ch = &priv->channel[queue];
 	unsigned int count = 0, error = 0, len = 0, per_queue_count = 0;
-	int status = 0, coe = priv->hw->rx_csum;
+	unsigned int rx_packets = 0, rx_dropped = 0, rx_errors = 0;
+	enum dma_data_direction dma_dir = tc956xmac_rx_dma_dir(priv);
+	struct bpf_prog *xdp_prog = READ_ONCE(priv->xdp_prog);
+	int status = 0, coe = priv->hw->rx_csum, xdp_status = 0;
 	unsigned int next_entry = rx_q->cur_rx;
 	struct sk_buff *skb = NULL;
+	u64 rx_bytes = 0;
 
 	if (netif_msg_rx_status(priv)) {
 		void *rx_head;
@@ -4638,10 +5596,10 @@ static int tc956xmac_rx(struct tc956xmac_priv *priv, int limit, u32 queue)
 		else
 			rx_head = (void *)rx_q->dma_rx;
 
-		tc956xmac_display_ring(priv, rx_head, DMA_RX_SIZE, true);
+		tc956xmac_display_ring(priv, rx_head, rx_q->dma_rx_size, true);
 	}
 	while (count < limit) {
-		unsigned int buf1_len = 0, buf2_len = 0;
+		unsigned int buf1_len = 0, buf2_len = 0, buf1_off;
 		enum pkt_hash_types hash_type;
 		struct tc956xmac_rx_buffer *buf;
 		struct dma_desc *np, *p;
@@ -4665,6 +5623,7 @@ static int tc956xmac_rx(struct tc956xmac_priv *priv, int limit, u32 queue)
 read_again:
 		buf1_len = 0;
 		buf2_len = 0;
+		buf1_off = tc956xmac_rx_offset(priv);
 		entry = next_entry;
 		buf = &rx_q->buf_pool[entry];
 
@@ -4680,7 +5639,7 @@ read_again:
 		if (unlikely(status & dma_own))
 			break;
 
-		rx_q->cur_rx = TC956XMAC_GET_ENTRY(rx_q->cur_rx, DMA_RX_SIZE);
+		rx_q->cur_rx = TC956XMAC_GET_ENTRY(rx_q->cur_rx, rx_q->dma_rx_size);
 		next_entry = rx_q->cur_rx;
 
 		if (priv->extend_desc)
@@ -4698,7 +5657,7 @@ read_again:
 			buf->page = NULL;
 			error = 1;
 			if (!priv->hwts_rx_en)
-				priv->dev->stats.rx_errors++;
+				rx_errors++;
 		}
 
 		if (unlikely(error && (status & rx_not_ls)))
@@ -4716,35 +5675,91 @@ read_again:
 		if (buf->sec_page)
 			prefetch(page_address(buf->sec_page));
 
-		buf1_len = tc956xmac_rx_buf1_len(priv, p, status, len);
+		buf1_len = tc956xmac_rx_buf1_len(priv, rx_q, p, status, len);
 		len += buf1_len;
-		buf2_len = tc956xmac_rx_buf2_len(priv, p, status, len);
+		buf2_len = tc956xmac_rx_buf2_len(priv, rx_q, p, status, len);
 		len += buf2_len;
 
+		if (buf1_len)
+			dma_sync_single_range_for_cpu(priv->device, buf->addr,
+						      buf1_off, buf1_len,
+						      dma_dir);
+
+		/* Run XDP on single buffer frames before any skb is built */
+		if (xdp_prog && !skb && !(status & rx_not_ls)) {
+			struct xdp_buff xdp;
+			int res;
+
+			xdp.data_hard_start = page_address(buf->page);
+			xdp.data = xdp.data_hard_start + buf1_off;
+			xdp.data_end = xdp.data + buf1_len;
+			xdp_set_data_meta_invalid(&xdp);
+			xdp.rxq = &rx_q->xdp_rxq;
+
+			res = tc956xmac_xdp_run_prog(priv, xdp_prog, &xdp);
+			if (res != TC956XMAC_XDP_PASS) {
+				if (res & TC956XMAC_XDP_CONSUMED) {
+					page_pool_recycle_direct(rx_q->page_pool,
+								 buf->page);
+					priv->xstats.rx_xdp_drop[queue]++;
+				} else if (res & TC956XMAC_XDP_TX) {
+					priv->xstats.rx_xdp_tx[queue]++;
+				} else {
+					priv->xstats.rx_xdp_redirect[queue]++;
+				}
+				/* Page now belongs to the pool or the XDP target */
+				buf->page = NULL;
+				xdp_status |= res;
+
+				rx_packets++;
+				rx_bytes += len;
+				count++;
+				continue;
+			}
+
+			/* The program may have moved the frame boundaries */
+			buf1_off = xdp.data - xdp.data_hard_start;
+			buf1_len = xdp.data_end - xdp.data;
+			len = buf1_len;
+		}
+
 		/* CRC stripping is done in MAC (CST &ACS bits) based on ethtool state*/
-		if (!skb) {
+		if (!skb && priv->rx_build_skb && buf1_len >= priv->rx_copybreak) {
+			/* Hand the page over to the stack, no copy */
+			skb = build_skb(page_address(buf->page),
+					PAGE_SIZE << tc956xmac_rx_page_order(priv));
+			if (!skb) {
+				rx_dropped++;
+				count++;
+				goto drain_data;
+			}
+
+			skb_reserve(skb, buf1_off);
+			skb_put(skb, buf1_len);
+
+			/* Page owned by the SKB now, refill allocates a new one */
+			page_pool_release_page(rx_q->page_pool, buf->page);
+			buf->page = NULL;
+		} else if (!skb) {
+			/* Below rx_copybreak copying is cheaper than a new page */
 			skb = napi_alloc_skb(&ch->rx_napi, buf1_len);
 			if (!skb) {
-				priv->dev->stats.rx_dropped++;
+				rx_dropped++;
 				count++;
 				goto drain_data;
 			}
 
-			dma_sync_single_for_cpu(priv->device, buf->addr,
-						buf1_len, DMA_FROM_DEVICE);
-			skb_copy_to_linear_data(skb, page_address(buf->page),
-						buf1_len);
+			skb_copy_to_linear_data(skb, page_address(buf->page) +
+						buf1_off, buf1_len);
 			skb_put(skb, buf1_len);
 
 			/* Data payload copied into SKB, page ready for recycle */
 			page_pool_recycle_direct(rx_q->page_pool, buf->page);
 			buf->page = NULL;
 		} else if (buf1_len) {
-			dma_sync_single_for_cpu(priv->device, buf->addr,
-						buf1_len, DMA_FROM_DEVICE);
 			skb_add_rx_frag(skb, skb_shinfo(skb)->nr_frags,
-					buf->page, 0, buf1_len,
-					priv->dma_buf_sz);
+					buf->page, buf1_off, buf1_len,
+					rx_q->dma_buf_sz);
 
 			/* Data payload appended into SKB */
 			page_pool_release_page(rx_q->page_pool, buf->page);
@@ -4753,10 +5768,10 @@ read_again:
 
 		if (buf2_len) {
 			dma_sync_single_for_cpu(priv->device, buf->sec_addr,
-						buf2_len, DMA_FROM_DEVICE);
+						buf2_len, dma_dir);
 			skb_add_rx_frag(skb, skb_shinfo(skb)->nr_frags,
 					buf->sec_page, 0, buf2_len,
-					priv->dma_buf_sz);
+					rx_q->dma_buf_sz);
 
 			/* Data payload appended into SKB */
 			page_pool_release_page(rx_q->page_pool, buf->sec_page);
@@ -4787,8 +5802,8 @@ drain_data:
 		napi_gro_receive(&ch->rx_napi, skb);
 		skb = NULL;
 
-		priv->dev->stats.rx_packets++;
-		priv->dev->stats.rx_bytes += len;
+		rx_packets++;
+		rx_bytes += len;
 		count++;
 		per_queue_count++;
 	}
@@ -4802,6 +5817,12 @@ drain_data:
 
 	tc956xmac_rx_refill(priv, queue);
 
+	if (xdp_status)
+		tc956xmac_finalize_xdp_rx(priv, xdp_status);
+
+	tc956xmac_rxq_stats_add(rx_q, rx_packets, rx_bytes, rx_dropped,
+				rx_errors);
+
 	/* priv->xstats.rx_pkt_n[queue]+= count; */
 	/* Count only Acceptd packet */
 	priv->xstats.rx_pkt_n[queue] += per_queue_count;
@@ -4810,6 +5831,441 @@ drain_data:
 	return count;
 }
 
+/**
+ * tc956xmac_rx_refill_zc - refill the RX ring from the AF_XDP fill queue
+ * @priv: driver private structure
+ * @queue: RX queue index
+ * Description: empty slots are those without a UMEM chunk, starting at
+ * dirty_rx. Returns false if the fill queue ran dry before the ring was full.
+ */
+static bool tc956xmac_rx_refill_zc(struct tc956xmac_priv *priv, u32 queue)
+{
+	struct tc956xmac_rx_queue *rx_q = &priv->rx_queue[queue];
+	unsigned int entry = rx_q->dirty_rx;
+	unsigned int refilled = 0;
+	bool ok = true;
+
+	while (rx_q->xsk_armed + refilled < rx_q->dma_rx_size) {
+		struct tc956xmac_rx_buffer *buf = &rx_q->buf_pool[entry];
+		struct dma_desc *p;
+		bool use_rx_wd;
+
+		if (buf->xsk_data)
+			break;
+
+		if (!tc956xmac_alloc_rx_buffer_zc(rx_q, buf)) {
+			ok = false;
+			break;
+		}
+
+		if (priv->extend_desc)
+			p = (struct dma_desc *)(rx_q->dma_erx + entry);
+		else
+			p = rx_q->dma_rx + entry;
+
+		dma_sync_single_for_device(priv->device, buf->addr,
+					   priv->dma_buf_sz, DMA_BIDIRECTIONAL);
+
+		tc956xmac_set_desc_addr(priv, p, buf->addr);
+		tc956xmac_set_desc_sec_addr(priv, p, 0);
+		tc956xmac_refill_desc3(priv, rx_q, p);
+
+		use_rx_wd = tc956xmac_rx_use_wd(priv, rx_q);
+
+		dma_wmb();
+		tc956xmac_set_rx_owner(priv, p, use_rx_wd);
+
+		entry = TC956XMAC_GET_ENTRY(entry, rx_q->dma_rx_size);
+		refilled++;
+	}
+
+	/* entry wraps back to dirty_rx when a whole ring is refilled */
+	if (refilled) {
+		rx_q->xsk_armed += refilled;
+		rx_q->dirty_rx = entry;
+		rx_q->rx_tail_addr = rx_q->dma_rx_phy +
+				    (rx_q->dirty_rx * sizeof(struct dma_desc));
+		tc956xmac_set_rx_tail_ptr(priv, priv->ioaddr,
+					  rx_q->rx_tail_addr, queue);
+	}
+
+	return ok;
+}
+
+/**
+ * tc956xmac_xdp_run_prog_zc - run the XDP program on a UMEM chunk
+ * @priv: driver private structure
+ * @prog: XDP program attached to the device
+ * @xdp: buffer holding the received frame
+ * @queue: RX queue index
+ * Description: returns TC956XMAC_XDP_CONSUMED when the chunk must be given
+ * back to the socket by the caller. For XDP_TX the frame is copied out of
+ * the UMEM by convert_to_xdp_frame(), which already releases the chunk.
+ */
+static int tc956xmac_xdp_run_prog_zc(struct tc956xmac_priv *priv,
+				     struct bpf_prog *prog,
+				     struct xdp_buff *xdp, u32 queue)
+{
+	struct xdp_umem *umem = priv->rx_queue[queue].xsk_umem;
+	struct xdp_frame *xdpf;
+	u32 act;
+	int res;
+
+	act = bpf_prog_run_xdp(prog, xdp);
+
+	/* Let the socket know where the program left the frame */
+	xdp->handle = xsk_umem_adjust_offset(umem, xdp->handle,
+					     xdp->data - xdp->data_hard_start);
+
+	switch (act) {
+	case XDP_PASS:
+		res = TC956XMAC_XDP_PASS;
+		break;
+	case XDP_TX:
+		xdpf = convert_to_xdp_frame(xdp);
+		if (unlikely(!xdpf)) {
+			res = TC956XMAC_XDP_CONSUMED;
+			priv->xstats.rx_xdp_drop[queue]++;
+			break;
+		}
+
+		if (tc956xmac_xdp_xmit_frame(priv, xdpf, true) !=
+		    TC956XMAC_XDP_TX) {
+			xdp_return_frame(xdpf);
+			priv->xstats.rx_xdp_drop[queue]++;
+		} else {
+			priv->xstats.rx_xdp_tx[queue]++;
+		}
+		res = TC956XMAC_XDP_TX;
+		break;
+	case XDP_REDIRECT:
+		if (xdp_do_redirect(priv->dev, xdp, prog) < 0) {
+			res = TC956XMAC_XDP_CONSUMED;
+			priv->xstats.rx_xdp_drop[queue]++;
+		} else {
+			res = TC956XMAC_XDP_REDIRECT;
+			priv->xstats.rx_xdp_redirect[queue]++;
+		}
+		break;
+	default:
+		bpf_warn_invalid_xdp_action(act);
+		/* fall through */
+	case XDP_ABORTED:
+		trace_xdp_exception(priv->dev, prog, act);
+		/* fall through */
+	case XDP_DROP:
+		res = TC956XMAC_XDP_CONSUMED;
+		priv->xstats.rx_xdp_drop[queue]++;
+		break;
+	}
+
+	return res;
+}
+
+/**
+ * tc956xmac_rx_zc - receive process of a queue bound to an AF_XDP socket
+ * @priv: driver private structure
+ * @limit: napi budget
+ * @queue: RX queue index.
+ * Description: frames are received straight into the UMEM chunks. Frames
+ * handed to the stack (XDP_PASS) are copied so the chunk can be recycled.
+ * Frames spanning several descriptors do not fit a chunk and are dropped.
+ */
+static int tc956xmac_rx_zc(struct tc956xmac_priv *priv, int limit, u32 queue)
+{
+	struct tc956xmac_rx_queue *rx_q = &priv->rx_queue[queue];
+	struct tc956xmac_channel *ch = &priv->channel[queue];
+	struct bpf_prog *xdp_prog = READ_ONCE(priv->xdp_prog);
+	int coe = priv->hw->rx_csum, xdp_status = 0;
+	unsigned int count = 0, per_queue_count = 0;
+	unsigned int rx_packets = 0, rx_dropped = 0, rx_errors = 0;
+	bool failure = false;
+	u64 rx_bytes = 0;
+
+	while (count < limit) {
+		unsigned int entry = rx_q->cur_rx;
+		struct tc956xmac_rx_buffer *buf = &rx_q->buf_pool[entry];
+		enum pkt_hash_types hash_type;
+		struct dma_desc *np, *p;
+		struct xdp_buff xdp;
+		struct sk_buff *skb;
+		unsigned int len;
+		int status, res;
+		u32 hash;
+
+		/* Slot not refilled yet, the DMA does not own it */
+		if (!buf->xsk_data)
+			break;
+
+		if (priv->extend_desc)
+			p = (struct dma_desc *)(rx_q->dma_erx + entry);
+		else
+			p = rx_q->dma_rx + entry;
+
+		status = tc956xmac_rx_status(priv, &priv->dev->stats,
+				&priv->xstats, p);
+		if (unlikely(status & dma_own))
+			break;
+
+		rx_q->cur_rx = TC956XMAC_GET_ENTRY(rx_q->cur_rx, rx_q->dma_rx_size);
+		rx_q->xsk_armed--;
+
+		if (priv->extend_desc)
+			np = (struct dma_desc *)(rx_q->dma_erx + rx_q->cur_rx);
+		else
+			np = rx_q->dma_rx + rx_q->cur_rx;
+
+		if (priv->extend_desc)
+			tc956xmac_rx_extended_status(priv, &priv->dev->stats,
+					&priv->xstats, rx_q->dma_erx + entry);
+
+		count++;
+
+		/* state.error tracks the tail of a dropped multi-buffer frame */
+		if (unlikely(status == discard_frame || (status & rx_not_ls) ||
+			     rx_q->state.error)) {
+			if (status == discard_frame && !priv->hwts_rx_en)
+				rx_errors++;
+			else if (!rx_q->state.error)
+				rx_dropped++;
+			rx_q->state.error = !!(status & rx_not_ls);
+			tc956xmac_recycle_rx_buffer_zc(rx_q, buf);
+			continue;
+		}
+
+		len = tc956xmac_get_rx_frame_len(priv, p, coe);
+		dma_sync_single_for_cpu(priv->device, buf->addr, len,
+					DMA_BIDIRECTIONAL);
+
+		xdp.data = buf->xsk_data;
+		xdp.data_meta = xdp.data;
+		xdp.data_hard_start = xdp.data - XDP_PACKET_HEADROOM;
+		xdp.data_end = xdp.data + len;
+		xdp.handle = buf->xsk_handle;
+		xdp.rxq = &rx_q->xdp_rxq;
+
+		res = TC956XMAC_XDP_PASS;
+		if (xdp_prog)
+			res = tc956xmac_xdp_run_prog_zc(priv, xdp_prog, &xdp,
+							queue);
+		if (res != TC956XMAC_XDP_PASS) {
+			if (res & TC956XMAC_XDP_CONSUMED)
+				tc956xmac_recycle_rx_buffer_zc(rx_q, buf);
+			else
+				buf->xsk_data = NULL;
+			xdp_status |= res;
+
+			rx_packets++;
+			rx_bytes += len;
+			continue;
+		}
+
+		/* The chunk belongs to the socket, hand a copy to the stack */
+		len = xdp.data_end - xdp.data;
+		skb = napi_alloc_skb(&ch->rx_napi, len);
+		if (!skb) {
+			rx_dropped++;
+			tc956xmac_recycle_rx_buffer_zc(rx_q, buf);
+			continue;
+		}
+
+		skb_put_data(skb, xdp.data, len);
+		tc956xmac_recycle_rx_buffer_zc(rx_q, buf);
+
+		tc956xmac_get_rx_hwtstamp(priv, p, np, skb);
+		tc956xmac_rx_vlan(priv->dev, skb);
+		skb->protocol = eth_type_trans(skb, priv->dev);
+
+		if (unlikely(!coe))
+			skb_checksum_none_assert(skb);
+		else
+			skb->ip_summed = CHECKSUM_UNNECESSARY;
+
+		if (!tc956xmac_get_rx_hash(priv, p, &hash, &hash_type))
+			skb_set_hash(skb, hash, hash_type);
+
+		skb_record_rx_queue(skb, queue);
+		napi_gro_receive(&ch->rx_napi, skb);
+
+		rx_packets++;
+		rx_bytes += len;
+		per_queue_count++;
+	}
+
+	failure = !tc956xmac_rx_refill_zc(priv, queue);
+
+	if (xdp_status)
+		tc956xmac_finalize_xdp_rx(priv, xdp_status);
+
+	tc956xmac_rxq_stats_add(rx_q, rx_packets, rx_bytes, rx_dropped,
+				rx_errors);
+	priv->xstats.rx_pkt_n[queue] += per_queue_count;
+
+	/* Ask userspace for more chunks when the ring could not be filled */
+	if (xsk_umem_uses_need_wakeup(rx_q->xsk_umem)) {
+		if (failure)
+			xsk_set_rx_need_wakeup(rx_q->xsk_umem);
+		else
+			xsk_clear_rx_need_wakeup(rx_q->xsk_umem);
+
+		return (int)count;
+	}
+
+	return failure ? limit : (int)count;
+}
+
+/**
+ * tc956xmac_xsk_xmit - send the frames queued on an AF_XDP socket
+ * @priv: driver private structure
+ * @queue: TX queue index
+ * @budget: maximum number of frames to send
+ * Description: the TX ring is shared with the stack, so the queue lock is
+ * taken and room is kept for regular traffic. Returns true once the socket
+ * TX ring is drained.
+ */
+static bool tc956xmac_xsk_xmit(struct tc956xmac_priv *priv, u32 queue,
+			       unsigned int budget)
+{
+	struct netdev_queue *nq = netdev_get_tx_queue(priv->dev, queue);
+	struct tc956xmac_tx_queue *tx_q = &priv->tx_queue[queue];
+	struct xdp_umem *umem = tx_q->xsk_umem;
+	int cpu = smp_processor_id();
+	unsigned int sent = 0;
+	bool drained = false;
+	struct xdp_desc desc;
+
+	__netif_tx_lock(nq, cpu);
+	/* Avoids TX time-out as we are sharing with slow path */
+	txq_trans_update(nq);
+
+	while (sent < budget) {
+		dma_addr_t dma_addr;
+
+		if (!netif_carrier_ok(priv->dev) ||
+		    tc956xmac_tx_avail(priv, queue) < TC956XMAC_TX_THRESH(tx_q))
+			break;
+
+		if (!xsk_umem_consume_tx(umem, &desc)) {
+			drained = true;
+			break;
+		}
+
+		dma_addr = xdp_umem_get_dma(umem, desc.addr);
+		dma_sync_single_for_device(priv->device, dma_addr, desc.len,
+					   DMA_BIDIRECTIONAL);
+
+		tc956xmac_xdp_fill_desc(priv, queue, dma_addr, desc.len,
+					TC956XMAC_TXBUF_T_XSK_TX);
+		sent++;
+	}
+
+	if (sent) {
+		tc956xmac_flush_tx_descriptors(priv, queue);
+		xsk_umem_consume_tx_done(umem);
+	}
+
+	__netif_tx_unlock(nq);
+
+	return drained;
+}
+
+/**
+ * tc956xmac_rx_dim_work - apply a new RX moderation profile
+ * @work: work_struct of the channel rx_dim
+ * Description: retunes the RIWT watchdog of the channel and the number of
+ * frames refilled before the interrupt on completion bit is set.
+ */
+static void tc956xmac_rx_dim_work(struct work_struct *work)
+{
+	struct dim *dim = container_of(work, struct dim, work);
+	struct tc956xmac_channel *ch =
+		container_of(dim, struct tc956xmac_channel, rx_dim);
+	struct tc956xmac_priv *priv = ch->priv_data;
+	struct tc956xmac_rx_queue *rx_q = &priv->rx_queue[ch->index];
+	struct dim_cq_moder moder;
+	u32 riwt;
+
+	moder = net_dim_get_rx_moderation(dim->mode, dim->profile_ix);
+
+	rx_q->rx_coal_frames = min_t(u32, moder.pkts, TC956XMAC_RX_MAX_FRAMES);
+
+	riwt = clamp_t(u32, tc956xmac_usec2riwt(moder.usec, priv),
+		       MIN_DMA_RIWT, MAX_DMA_RIWT);
+	if (priv->use_riwt && riwt != rx_q->rx_riwt) {
+		rx_q->rx_riwt = riwt;
+		tc956xmac_set_rx_watchdog(priv, priv->ioaddr, riwt, ch->index);
+	}
+
+	dim->state = DIM_START_MEASURE;
+}
+
+/**
+ * tc956xmac_tx_dim_work - apply a new TX moderation profile
+ * @work: work_struct of the channel tx_dim
+ * Description: retunes the number of frames queued before the interrupt on
+ * completion bit is set, the TX timer still bounds the completion latency.
+ */
+static void tc956xmac_tx_dim_work(struct work_struct *work)
+{
+	struct dim *dim = container_of(work, struct dim, work);
+	struct tc956xmac_channel *ch =
+		container_of(dim, struct tc956xmac_channel, tx_dim);
+	struct tc956xmac_priv *priv = ch->priv_data;
+	struct tc956xmac_tx_queue *tx_q = &priv->tx_queue[ch->index];
+	struct dim_cq_moder moder;
+
+	moder = net_dim_get_tx_moderation(dim->mode, dim->profile_ix);
+
+	/* Never ask for more completions than the wake up threshold */
+	tx_q->tx_coal_frames = clamp_t(u32, moder.pkts, 1,
+				       TC956XMAC_TX_THRESH(tx_q));
+
+	dim->state = DIM_START_MEASURE;
+}
+
+/**
+ * tc956xmac_rx_dim_update - feed the RX counters of a NAPI run to net_dim
+ * @priv: driver private structure
+ * @ch: channel that just polled
+ */
+static void tc956xmac_rx_dim_update(struct tc956xmac_priv *priv,
+				    struct tc956xmac_channel *ch)
+{
+	struct tc956xmac_rxq_stats *rxq_stats =
+		&priv->rx_queue[ch->index].rxq_stats;
+	struct dim_sample dim_sample = {};
+
+	/* The RX counters are only written by this NAPI instance */
+	dim_update_sample(++ch->rx_dim_events, rxq_stats->rx_packets,
+			  rxq_stats->rx_bytes, &dim_sample);
+	net_dim(&ch->rx_dim, dim_sample);
+}
+
+/**
+ * tc956xmac_tx_dim_update - feed the TX counters of a NAPI run to net_dim
+ * @priv: driver private structure
+ * @ch: channel that just polled
+ */
+static void tc956xmac_tx_dim_update(struct tc956xmac_priv *priv,
+				    struct tc956xmac_channel *ch)
+{
+	struct tc956xmac_txq_stats *txq_stats =
+		&priv->tx_queue[ch->index].txq_stats;
+	struct dim_sample dim_sample = {};
+	u64 packets, bytes;
+	unsigned int start;
+
+	/* tx_packets is only written by this NAPI instance */
+	packets = txq_stats->tx_packets;
+	do {
+		start = u64_stats_fetch_begin_irq(&txq_stats->syncp);
+		bytes = txq_stats->tx_bytes;
+	} while (u64_stats_fetch_retry_irq(&txq_stats->syncp, start));
+
+	dim_update_sample(++ch->tx_dim_events, packets, bytes, &dim_sample);
+	net_dim(&ch->tx_dim, dim_sample);
+}
+
 static int tc956xmac_napi_poll_rx(struct napi_struct *napi, int budget)
 {
 	struct tc956xmac_channel *ch =
@@ -4820,7 +6276,17 @@ static int tc956xmac_napi_poll_rx(struct napi_struct *napi, int budget)
 
 	priv->xstats.napi_poll_rx[chan]++;
 
-	work_done = tc956xmac_rx(priv, budget, chan);
+	if (priv->rx_queue[chan].xsk_umem)
+		work_done = tc956xmac_rx_zc(priv, budget, chan);
+	else
+		work_done = tc956xmac_rx(priv, budget, chan);
+
+	if (priv->rx_dim_enabled)
+		tc956xmac_rx_dim_update(priv, ch);
+
+	if (work_done)
+		ch->rbu_events = 0;
+
 	if (work_done < budget && napi_complete_done(napi, work_done)) {
 		unsigned long flags;
 
@@ -4842,9 +6308,18 @@ static int tc956xmac_napi_poll_tx(struct napi_struct *napi, int budget)
 
 	priv->xstats.napi_poll_tx[chan]++;
 
-	work_done = tc956xmac_tx_clean(priv, DMA_TX_SIZE, chan);
+	work_done = tc956xmac_tx_clean(priv, priv->tx_queue[chan].dma_tx_size,
+				       chan);
 	work_done = min(work_done, budget);
 
+	/* Keep polling until the AF_XDP socket has nothing left to send */
+	if (priv->tx_queue[chan].xsk_umem &&
+	    !tc956xmac_xsk_xmit(priv, chan, budget))
+		work_done = budget;
+
+	if (priv->tx_dim_enabled)
+		tc956xmac_tx_dim_update(priv, ch);
+
 	if (work_done < budget && napi_complete_done(napi, work_done)) {
 		unsigned long flags;
 
@@ -4857,34 +6332,362 @@ static int tc956xmac_napi_poll_tx(struct napi_struct *napi, int budget)
 }
 
 /**
- *  tc956xmac_tx_timeout
- *  @dev : Pointer to net device structure
- *  Description: this function is called when a packet transmission fails to
- *   complete within a reasonable time. The driver will mark the error in the
- *   netdev structure and arrange for the device to be reset to a sane state
- *   in order to transmit a new packet.
+ *  tc956xmac_tx_timeout
+ *  @dev : Pointer to net device structure
+ *  Description: this function is called when a packet transmission fails to
+ *   complete within a reasonable time. Only the DMA channels of the stuck
+ *   queues are restarted, the link and the other queues keep running.
+ */
+static void tc956xmac_tx_timeout(struct net_device *dev)
+{
+	struct tc956xmac_priv *priv = netdev_priv(dev);
+	u32 queue;
+
+	for (queue = 0; queue < priv->plat->tx_queues_to_use; queue++) {
+		struct netdev_queue *txq = netdev_get_tx_queue(dev, queue);
+
+		if (priv->plat->tx_dma_ch_owner[queue] != USE_IN_TC956X_SW)
+			continue;
+
+		if (netif_xmit_stopped(txq) &&
+		    time_after(jiffies, txq->trans_start + dev->watchdog_timeo)) {
+			netdev_warn(dev, "TX queue %u timed out\n", queue);
+			tc956xmac_chan_err(priv, queue, true, false);
+		}
+	}
+}
+
+/**
+ *  tc956xmac_get_stats64 - entry point for the interface statistics
+ *  @dev : pointer to the device structure
+ *  @stats : statistics to fill
+ *  Description:
+ *  The hot path counters are kept per queue, dev->stats only holds the
+ *  errors accounted from slow paths.
+ */
+static void tc956xmac_get_stats64(struct net_device *dev,
+				  struct rtnl_link_stats64 *stats)
+{
+	struct tc956xmac_priv *priv = netdev_priv(dev);
+	unsigned int start;
+	u32 queue;
+
+	netdev_stats_to_stats64(stats, &dev->stats);
+
+	for (queue = 0; queue < priv->plat->rx_queues_to_use; queue++) {
+		struct tc956xmac_rxq_stats *rxq_stats =
+			&priv->rx_queue[queue].rxq_stats;
+		u64 packets, bytes, dropped, errors;
+
+		do {
+			start = u64_stats_fetch_begin_irq(&rxq_stats->syncp);
+			packets = rxq_stats->rx_packets;
+			bytes = rxq_stats->rx_bytes;
+			dropped = rxq_stats->rx_dropped;
+			errors = rxq_stats->rx_errors;
+		} while (u64_stats_fetch_retry_irq(&rxq_stats->syncp, start));
+
+		stats->rx_packets += packets;
+		stats->rx_bytes += bytes;
+		stats->rx_dropped += dropped;
+		stats->rx_errors += errors;
+	}
+
+	for (queue = 0; queue < priv->plat->tx_queues_to_use; queue++) {
+		struct tc956xmac_txq_stats *txq_stats =
+			&priv->tx_queue[queue].txq_stats;
+		u64 packets, bytes, dropped, errors;
+
+		do {
+			start = u64_stats_fetch_begin_irq(&txq_stats->syncp);
+			bytes = txq_stats->tx_bytes;
+			dropped = txq_stats->tx_dropped;
+		} while (u64_stats_fetch_retry_irq(&txq_stats->syncp, start));
+
+		do {
+			start = u64_stats_fetch_begin_irq(&txq_stats->napi_syncp);
+			packets = txq_stats->tx_packets;
+			errors = txq_stats->tx_errors;
+		} while (u64_stats_fetch_retry_irq(&txq_stats->napi_syncp,
+						   start));
+
+		stats->tx_packets += packets;
+		stats->tx_bytes += bytes;
+		stats->tx_dropped += dropped;
+		stats->tx_errors += errors;
+	}
+}
+
+/**
+ *  tc956xmac_set_rx_mode - entry point for multicast addressing
+ *  @dev : pointer to the device structure
+ *  Description:
+ *  This function is a driver entry point which gets called by the kernel
+ *  whenever multicast addresses must be enabled/disabled.
+ *  Return value:
+ *  void.
+ */
+static void tc956xmac_set_rx_mode(struct net_device *dev)
+{
+	struct tc956xmac_priv *priv = netdev_priv(dev);
+
+	tc956xmac_set_filter(priv, priv->hw, dev);
+}
+
+/**
+ * tc956xmac_rx_ring_fill - give every RX descriptor a buffer
+ * @priv: driver private structure
+ * @queue: RX queue index
+ * Description: allocates the buffers still waiting for a refill, the ring
+ * itself is left untouched.
+ */
+static int tc956xmac_rx_ring_fill(struct tc956xmac_priv *priv, u32 queue)
+{
+	struct tc956xmac_rx_queue *rx_q = &priv->rx_queue[queue];
+	unsigned int entry;
+
+	for (entry = 0; entry < rx_q->dma_rx_size; entry++) {
+		struct tc956xmac_rx_buffer *buf = &rx_q->buf_pool[entry];
+
+		if (!buf->page) {
+			buf->page = page_pool_dev_alloc_pages(rx_q->page_pool);
+			if (!buf->page)
+				return -ENOMEM;
+		}
+
+		if (priv->sph && !buf->sec_page) {
+			buf->sec_page = page_pool_dev_alloc_pages(rx_q->page_pool);
+			if (!buf->sec_page)
+				return -ENOMEM;
+
+			buf->sec_addr = page_pool_get_dma_addr(buf->sec_page);
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * tc956xmac_rx_ring_rearm - hand a filled RX ring back to the DMA
+ * @priv: driver private structure
+ * @queue: RX queue index
+ * Description: the RX DMA of the channel must be stopped. Frames still in
+ * the ring are dropped and every descriptor is re-armed, starting from the
+ * first entry, with the buffer size of the queue.
+ */
+static void tc956xmac_rx_ring_rearm(struct tc956xmac_priv *priv, u32 queue)
+{
+	struct tc956xmac_rx_queue *rx_q = &priv->rx_queue[queue];
+	int len = DIV_ROUND_UP(rx_q->dma_buf_sz, PAGE_SIZE) * PAGE_SIZE;
+	unsigned int entry;
+
+	if (rx_q->state_saved) {
+		dev_kfree_skb(rx_q->state.skb);
+		rx_q->state.skb = NULL;
+		rx_q->state_saved = false;
+		priv->dev->stats.rx_dropped++;
+	}
+
+	for (entry = 0; entry < rx_q->dma_rx_size; entry++) {
+		struct tc956xmac_rx_buffer *buf = &rx_q->buf_pool[entry];
+		struct dma_desc *p;
+
+		if (priv->extend_desc)
+			p = (struct dma_desc *)(rx_q->dma_erx + entry);
+		else
+			p = rx_q->dma_rx + entry;
+
+		buf->addr = page_pool_get_dma_addr(buf->page);
+		dma_sync_single_for_device(priv->device, buf->addr, len,
+					   tc956xmac_rx_dma_dir(priv));
+		if (buf->sec_page)
+			dma_sync_single_for_device(priv->device, buf->sec_addr,
+						   len, tc956xmac_rx_dma_dir(priv));
+
+		tc956xmac_set_desc_addr(priv, p, buf->addr +
+					tc956xmac_rx_offset(priv));
+		tc956xmac_set_desc_sec_addr(priv, p, buf->sec_addr);
+		tc956xmac_refill_desc3(priv, rx_q, p);
+
+		dma_wmb();
+		tc956xmac_set_rx_owner(priv, p, tc956xmac_rx_use_wd(priv, rx_q));
+	}
+
+	rx_q->cur_rx = 0;
+	rx_q->dirty_rx = 0;
+}
+
+/**
+ * tc956xmac_rx_chan_resize - switch one RX channel to a new buffer size
+ * @priv: driver private structure
+ * @queue: RX queue index
+ * @bfsize: new DMA buffer size
+ * Description: the channel is quiesced on its own while the link and the
+ * other channels keep running. Every descriptor gets a buffer before the DMA
+ * is stopped, so that an allocation failure leaves the channel at its old
+ * size. Frames still in the ring are dropped and the ring restarts from its
+ * first entry. Called with the current size, it restarts a faulty channel.
+ */
+static int tc956xmac_rx_chan_resize(struct tc956xmac_priv *priv, u32 queue,
+				    unsigned int bfsize)
+{
+	struct tc956xmac_rx_queue *rx_q = &priv->rx_queue[queue];
+	struct tc956xmac_channel *ch = &priv->channel[queue];
+	int ret;
+
+	napi_disable(&ch->rx_napi);
+
+	ret = tc956xmac_rx_ring_fill(priv, queue);
+	if (ret)
+		goto out;
+
+	tc956xmac_stop_rx_dma(priv, queue);
+
+	rx_q->dma_buf_sz = bfsize;
+	tc956xmac_rx_ring_rearm(priv, queue);
+
+	/* Rewriting the list address rewinds the DMA to the first entry */
+	tc956xmac_init_rx_chan(priv, priv->ioaddr, priv->plat->dma_cfg,
+			       rx_q->dma_rx_phy, queue);
+	tc956xmac_set_dma_bfsize(priv, priv->ioaddr, bfsize, queue);
+
+	rx_q->rx_tail_addr = rx_q->dma_rx_phy +
+			    (rx_q->dma_rx_size * sizeof(struct dma_desc));
+	tc956xmac_set_rx_tail_ptr(priv, priv->ioaddr, rx_q->rx_tail_addr, queue);
+
+	tc956xmac_start_rx_dma(priv, queue);
+
+out:
+	napi_enable(&ch->rx_napi);
+
+	return ret;
+}
+
+/**
+ * tc956xmac_rx_resize - switch the running RX channels to a new MTU
+ * @priv: driver private structure
+ * @mtu: new MTU
+ * Description: only the RX buffer size depends on the MTU. The pages and the
+ * ring layout stay the same, so the channels are switched one at a time
+ * without releasing the interface.
+ */
+static int tc956xmac_rx_resize(struct tc956xmac_priv *priv, int mtu)
+{
+	int bfsize = tc956xmac_rx_bfsize(priv, mtu);
+	u32 queue;
+	int ret;
+
+	if (bfsize == priv->dma_buf_sz)
+		return 0;
+
+	/* Zero-copy chunks are sized against the current buffers, and the
+	 * pools cannot change their page order under the stack.
+	 */
+	if (priv->af_xdp_zc_qps ||
+	    ilog2(DIV_ROUND_UP(bfsize, PAGE_SIZE)) != tc956xmac_rx_page_order(priv))
+		return -EBUSY;
+
+	for (queue = 0; queue < priv->plat->rx_queues_to_use; queue++) {
+		if (priv->plat->rx_dma_ch_owner[queue] != USE_IN_TC956X_SW)
+			continue;
+
+		ret = tc956xmac_rx_chan_resize(priv, queue, bfsize);
+		if (ret)
+			goto err;
+	}
+
+	priv->dma_buf_sz = bfsize;
+
+	return 0;
+
+err:
+	/* Bring the channels already switched back to the old size */
+	while (queue-- > 0) {
+		if (priv->plat->rx_dma_ch_owner[queue] != USE_IN_TC956X_SW)
+			continue;
+
+		tc956xmac_rx_chan_resize(priv, queue, priv->dma_buf_sz);
+	}
+
+	return ret;
+}
+
+/**
+ * tc956xmac_tx_chan_reset - restart the TX path of one DMA channel
+ * @priv: driver private structure
+ * @chan: channel index
+ * Description: pending frames are dropped and the ring restarts empty. The
+ * TX lock is held all along since XDP_TX and ndo_xdp_xmit take it but do
+ * not look at the queue state.
  */
-static void tc956xmac_tx_timeout(struct net_device *dev)
+static void tc956xmac_tx_chan_reset(struct tc956xmac_priv *priv, u32 chan)
 {
-	struct tc956xmac_priv *priv = netdev_priv(dev);
+	struct netdev_queue *txq = netdev_get_tx_queue(priv->dev, chan);
+	struct tc956xmac_channel *ch = &priv->channel[chan];
+
+	napi_disable(&ch->tx_napi);
 
-	tc956xmac_global_err(priv);
+	__netif_tx_lock_bh(txq);
+	tc956xmac_tx_err(priv, chan);
+	__netif_tx_unlock_bh(txq);
+
+	napi_enable(&ch->tx_napi);
 }
 
 /**
- *  tc956xmac_set_rx_mode - entry point for multicast addressing
- *  @dev : pointer to the device structure
- *  Description:
- *  This function is a driver entry point which gets called by the kernel
- *  whenever multicast addresses must be enabled/disabled.
- *  Return value:
- *  void.
+ * tc956xmac_chan_reset_task - restart the DMA channels reported faulty
+ * @work: work_struct embedded in the driver private structure
+ * Description: only the affected channels are quiesced and reinitialized,
+ * the PHY link and the other channels keep running.
  */
-static void tc956xmac_set_rx_mode(struct net_device *dev)
+static void tc956xmac_chan_reset_task(struct work_struct *work)
 {
-	struct tc956xmac_priv *priv = netdev_priv(dev);
+	struct tc956xmac_priv *priv = container_of(work, struct tc956xmac_priv,
+						   chan_reset_task);
+	unsigned long tx_mask, rx_mask;
+	u32 chan;
 
-	tc956xmac_set_filter(priv, priv->hw, dev);
+	rtnl_lock();
+
+	tx_mask = xchg(&priv->tx_reset_mask, 0);
+	rx_mask = xchg(&priv->rx_reset_mask, 0);
+
+	if (!netif_running(priv->dev) ||
+	    test_bit(TC956XMAC_DOWN, &priv->state))
+		goto out;
+
+	for_each_set_bit(chan, &tx_mask, TC956XMAC_CH_MAX) {
+		if (chan >= priv->plat->tx_queues_to_use ||
+		    priv->plat->tx_dma_ch_owner[chan] != USE_IN_TC956X_SW)
+			continue;
+
+		netdev_warn(priv->dev, "Restarting TX DMA channel %u\n", chan);
+		tc956xmac_tx_chan_reset(priv, chan);
+	}
+
+	for_each_set_bit(chan, &rx_mask, TC956XMAC_CH_MAX) {
+		struct tc956xmac_rx_queue *rx_q = &priv->rx_queue[chan];
+
+		if (chan >= priv->plat->rx_queues_to_use ||
+		    priv->plat->rx_dma_ch_owner[chan] != USE_IN_TC956X_SW)
+			continue;
+
+		/* Zero-copy buffers belong to the UMEM fill queue */
+		if (rx_q->xsk_umem) {
+			netdev_warn(priv->dev,
+				    "RX DMA channel %u bound to AF_XDP, not restarted\n",
+				    chan);
+			continue;
+		}
+
+		netdev_warn(priv->dev, "Restarting RX DMA channel %u\n", chan);
+		if (tc956xmac_rx_chan_resize(priv, chan, rx_q->dma_buf_sz))
+			netdev_err(priv->dev,
+				   "Cannot restart RX DMA channel %u\n", chan);
+	}
+
+out:
+	rtnl_unlock();
 }
 
 /**
@@ -4909,9 +6712,9 @@ static int tc956xmac_change_mtu(struct net_device *dev, int new_mtu)
 
 	txfifosz /= priv->plat->tx_queues_to_use;
 
-	if (netif_running(dev)) {
-		netdev_err(priv->dev, "must be stopped to change its MTU\n");
-		return -EBUSY;
+	if (tc956xmac_xdp_is_enabled(priv) && new_mtu > ETH_DATA_LEN) {
+		netdev_dbg(priv->dev, "Jumbo frames not supported for XDP\n");
+		return -EINVAL;
 	}
 
 	new_mtu = TC956XMAC_ALIGN(new_mtu);
@@ -4924,11 +6727,27 @@ static int tc956xmac_change_mtu(struct net_device *dev, int new_mtu)
 		return -EINVAL;
 	}
 
+	if (!tc956xmac_tx_fifo_fits(priv->tx_fifo_split, new_mtu)) {
+		netdev_err(priv->dev, "MTU %d does not fit the TX FIFO of %d queues\n",
+			   new_mtu, priv->plat->tx_queues_to_use);
+		return -EINVAL;
+	}
+
 #else
 	/* If condition true, FIFO is too small or MTU too large */
 	if ((txfifosz < new_mtu) || (new_mtu > BUF_SIZE_16KiB))
 		return -EINVAL;
 #endif
+	if (netif_running(dev)) {
+		int ret = tc956xmac_rx_resize(priv, new_mtu);
+
+		if (ret) {
+			netdev_err(priv->dev, "%s: cannot resize RX buffers (error: %d)\n",
+				   __func__, ret);
+			return ret;
+		}
+	}
+
 	dev->mtu = new_mtu;
 
 	netdev_update_features(dev);
@@ -4936,6 +6755,24 @@ static int tc956xmac_change_mtu(struct net_device *dev, int new_mtu)
 	return 0;
 }
 
+static bool tc956xmac_rxp_steering(struct tc956xmac_priv *priv)
+{
+	int i;
+
+	for (i = 0; i < TC956XMAC_RX_NFC_MAX; i++) {
+		if (priv->rx_nfc[i].in_use &&
+		    priv->rx_nfc[i].fs.ring_cookie != RX_CLS_FLOW_DISC)
+			return true;
+	}
+
+	for (i = 0; i < TC956XMAC_RXP_FLOW_MAX; i++) {
+		if (priv->rxp_flows[i].in_use && priv->rxp_flows[i].steer)
+			return true;
+	}
+
+	return false;
+}
+
 static netdev_features_t tc956xmac_fix_features(struct net_device *dev,
 					     netdev_features_t features)
 {
@@ -4955,9 +6792,13 @@ static netdev_features_t tc956xmac_fix_features(struct net_device *dev,
 	if (priv->plat->bugged_jumbo && (dev->mtu > ETH_DATA_LEN))
 		features &= ~NETIF_F_CSUM_MASK;
 
-	/* Disable tso if asked by ethtool */
+	/* Steering rules in the RX parser rely on the RSS channel selection */
+	if ((dev->features & NETIF_F_RXHASH) && tc956xmac_rxp_steering(priv))
+		features |= NETIF_F_RXHASH;
+
+	/* Disable tso if asked by ethtool, USO runs on the same engine */
 	if ((priv->plat->tso_en) && (priv->dma_cap.tsoen)) {
-		if (features & NETIF_F_TSO)
+		if (features & (NETIF_F_TSO | NETIF_F_GSO_UDP_L4))
 			priv->tso = true;
 		else
 			priv->tso = false;
@@ -5006,6 +6847,15 @@ static int tc956xmac_set_features(struct net_device *netdev,
 	for (chan = 0; chan < priv->plat->rx_queues_to_use; chan++)
 		tc956xmac_enable_sph(priv, priv->ioaddr, sph_en, chan);
 
+	/* Receive Side Scaling follows the rx hash offload */
+	if (((netdev->features ^ features) & NETIF_F_RXHASH) &&
+	    priv->dma_cap.rssen && priv->plat->rss_en &&
+	    priv->plat->rx_queues_to_use > 1) {
+		priv->rss.enable = !!(features & NETIF_F_RXHASH);
+		tc956xmac_rss_configure(priv, priv->hw, &priv->rss,
+					priv->mtl_rx_queues);
+	}
+
 	return 0;
 }
 
@@ -5088,8 +6938,11 @@ static irqreturn_t tc956xmac_interrupt(int irq, void *dev_id)
 		}
 	}
 
-	/* To handle DMA interrupts */
-	tc956xmac_dma_interrupt(priv);
+	/* To handle DMA interrupts, in multi vector mode every channel is
+	 * serviced by its own vector.
+	 */
+	if (!priv->msi_multi_vec)
+		tc956xmac_dma_interrupt(priv);
 
 	val = readl(priv->ioaddr + TC956X_MSI_INT_STS_OFFSET(priv->port_num));
 	if (val & TC956X_EXT_PHY_ETH_INT)
@@ -5110,9 +6963,23 @@ static irqreturn_t tc956xmac_interrupt(int irq, void *dev_id)
  */
 static void tc956xmac_poll_controller(struct net_device *dev)
 {
+	struct tc956xmac_priv *priv = netdev_priv(dev);
+	u32 chan;
+
 	disable_irq(dev->irq);
 	tc956xmac_interrupt(dev->irq, dev);
 	enable_irq(dev->irq);
+
+	for (chan = 0; priv->msi_multi_vec && chan < TC956XMAC_CH_MAX; chan++) {
+		struct tc956xmac_channel *ch = &priv->channel[chan];
+
+		if (!tc956xmac_chan_in_use(priv, chan))
+			continue;
+
+		disable_irq(ch->irq);
+		tc956xmac_msi_intr_chan(ch->irq, ch);
+		enable_irq(ch->irq);
+	}
 }
 #endif
 #endif /* TC956X_UNSUPPORTED_UNTESTED_FEATURE */
@@ -5121,6 +6988,9 @@ int tc956xmac_rx_parser_configuration(struct tc956xmac_priv *priv)
 {
 	int ret = -EINVAL;
 
+	/* The dynamic table is no longer what the HW holds */
+	priv->rxp_hw_valid = false;
+
 	if (priv->hw->mac->rx_parser_init && priv->plat->rxp_cfg.enable)
 		ret = tc956xmac_rx_parser_init(priv,
 			priv->dev, priv->hw, priv->dma_cap.spram,
@@ -8519,6 +10389,54 @@ static int tc956xmac_setup_tc(struct net_device *ndev, enum tc_setup_type type,
 	}
 }
 
+#ifdef TC956X
+/**
+ * tc956xmac_init_be_queues - build the set of best-effort TX queues
+ * @priv: driver private structure
+ * Description: keeps the queues of the tx_be_queues parameter, as updated by
+ * ethtool -L, that are in use and driven by the host. With TSO on, only TSO
+ * capable queues are kept so that the frames of a TCP flow never change
+ * queue.
+ */
+static void tc956xmac_init_be_queues(struct tc956xmac_priv *priv)
+{
+	u32 queue;
+
+	priv->tx_be_queue_cnt = 0;
+	for (queue = 0; queue < priv->plat->tx_queues_to_use; queue++) {
+		if (!(priv->tx_be_mask & BIT(queue)))
+			continue;
+		if (priv->plat->tx_dma_ch_owner[queue] != USE_IN_TC956X_SW)
+			continue;
+		if (priv->tso && !priv->plat->tx_queues_cfg[queue].tso_en)
+			continue;
+
+		priv->tx_be_queue[priv->tx_be_queue_cnt++] = queue;
+	}
+
+	if (!priv->tx_be_queue_cnt) {
+		priv->tx_be_queue[0] = HOST_BEST_EFF_CH;
+		priv->tx_be_queue_cnt = 1;
+	}
+}
+
+/**
+ * tc956xmac_select_be_queue - TX queue of a best-effort frame
+ * @priv: driver private structure
+ * @skb: frame to transmit
+ * Description: the flow hash keeps each flow on a single queue.
+ */
+static inline u16 tc956xmac_select_be_queue(struct tc956xmac_priv *priv,
+					    struct sk_buff *skb)
+{
+	if (priv->tx_be_queue_cnt == 1)
+		return priv->tx_be_queue[0];
+
+	return priv->tx_be_queue[reciprocal_scale(skb_get_hash(skb),
+						  priv->tx_be_queue_cnt)];
+}
+#endif
+
 static u16 tc956xmac_select_queue(struct net_device *dev, struct sk_buff *skb,
 			       struct net_device *sb_dev)
 {
@@ -8545,9 +10463,9 @@ static u16 tc956xmac_select_queue(struct net_device *dev, struct sk_buff *skb,
 			else if (avb_priority == TC956X_PRIORITY_CLASS_CDT)
 				txqueue_select = TSN_CLASS_CDT_TX_CH;
 			else
-				txqueue_select = HOST_BEST_EFF_CH;
+				txqueue_select = tc956xmac_select_be_queue(priv, skb);
 		} else {
-			txqueue_select = LEGACY_VLAN_TAGGED_CH;
+			txqueue_select = tc956xmac_select_be_queue(priv, skb);
 		}
 	} else {
 		switch (eth_or_vlan_tag) {
@@ -8555,7 +10473,7 @@ static u16 tc956xmac_select_queue(struct net_device *dev, struct sk_buff *skb,
 			txqueue_select = TC956X_GPTP_TX_CH;
 			break;
 		default:
-			txqueue_select = HOST_BEST_EFF_CH;
+			txqueue_select = tc956xmac_select_be_queue(priv, skb);
 			break;
 		}
 	}
@@ -8645,11 +10563,11 @@ static int tc956xmac_rings_status_show(struct seq_file *seq, void *v)
 		if (priv->extend_desc) {
 			seq_printf(seq, "Extended descriptor ring:\n");
 			sysfs_display_ring((void *)rx_q->dma_erx,
-					   DMA_RX_SIZE, 1, seq);
+					   rx_q->dma_rx_size, 1, seq);
 		} else {
 			seq_printf(seq, "Descriptor ring:\n");
 			sysfs_display_ring((void *)rx_q->dma_rx,
-					   DMA_RX_SIZE, 0, seq);
+					   rx_q->dma_rx_size, 0, seq);
 		}
 	}
 
@@ -8664,11 +10582,11 @@ static int tc956xmac_rings_status_show(struct seq_file *seq, void *v)
 		if (priv->extend_desc) {
 			seq_printf(seq, "Extended descriptor ring:\n");
 			sysfs_display_ring((void *)tx_q->dma_etx,
-					   DMA_TX_SIZE, 1, seq);
+					   tx_q->dma_tx_size, 1, seq);
 		} else if (!(tx_q->tbs & TC956XMAC_TBS_AVAIL)) {
 			seq_printf(seq, "Descriptor ring:\n");
 			sysfs_display_ring((void *)tx_q->dma_tx,
-					   DMA_TX_SIZE, 0, seq);
+					   tx_q->dma_tx_size, 0, seq);
 		}
 	}
 
@@ -8804,6 +10722,57 @@ static struct notifier_block tc956xmac_notifier = {
 	.notifier_call = tc956xmac_device_event,
 };
 #endif
+
+#ifdef TC956X_UNSUPPORTED_UNTESTED_FEATURE
+/* RX parser rules in table order, with the HW entries each one takes */
+static int tc956xmac_rx_parser_show(struct seq_file *seq, void *v)
+{
+	struct net_device *dev = seq->private;
+	struct tc956xmac_priv *priv = netdev_priv(dev);
+	struct tc956xmac_tc_entry *entry, *frag, *first;
+	unsigned int i, key, first_key = 0, pos = 0;
+
+	rtnl_lock();
+	seq_printf(seq, "HW entries: %u used, %u total, bank at %u\n",
+		   priv->rxp_hw_valid ? priv->rxp_hw_nve : 0,
+		   priv->rxp_hw_size, priv->rxp_hw_base);
+	seq_puts(seq, "action\tprio\t\thandle\t\tentries\tshared\n");
+
+	/* Walk the rules by the position of their action entry, heads of
+	 * rules sharing a prefix sit at the same position.
+	 */
+	while (1) {
+		first = NULL;
+		for (i = 0; i < priv->tc_entries_max; i++) {
+			entry = &priv->tc_entries[i];
+			if (!entry->in_use || !entry->in_hw || entry->is_frag ||
+			    entry->is_last)
+				continue;
+
+			for (frag = entry; frag->frag_ptr; frag = frag->frag_ptr)
+				;
+			key = frag->table_pos;
+			if (key < pos || (first && key >= first_key))
+				continue;
+
+			first = entry;
+			first_key = key;
+		}
+		if (!first)
+			break;
+
+		seq_printf(seq, "%u\t0x%08x\t0x%08x\t%u\t%u\n",
+			   first_key, first->prio, first->handle,
+			   first->hw_entries, first->hw_shared);
+		pos = first_key + 1;
+	}
+	rtnl_unlock();
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(tc956xmac_rx_parser);
+#endif /* TC956X_UNSUPPORTED_UNTESTED_FEATURE */
+
 static void tc956xmac_init_fs(struct net_device *dev)
 {
 	struct tc956xmac_priv *priv = netdev_priv(dev);
@@ -8811,6 +10780,13 @@ static void tc956xmac_init_fs(struct net_device *dev)
 	/* Create per netdev entries */
 	priv->dbgfs_dir = debugfs_create_dir(dev->name, tc956xmac_fs_dir);
 
+#ifdef TC956X_UNSUPPORTED_UNTESTED_FEATURE
+	/* Entry to report the RX parser rules */
+	if (priv->tc_entries)
+		debugfs_create_file("rx_parser", 0444, priv->dbgfs_dir, dev,
+				    &tc956xmac_rx_parser_fops);
+#endif
+
 #ifndef TC956X
 	/* Entry to report DMA RX/TX rings */
 	debugfs_create_file("descriptors_status", 0444, priv->dbgfs_dir, dev,
@@ -8820,69 +10796,334 @@ static void tc956xmac_init_fs(struct net_device *dev)
 	debugfs_create_file("dma_cap", 0444, priv->dbgfs_dir, dev,
 			    &tc956xmac_dma_cap_fops);
 
-	register_netdevice_notifier(&tc956xmac_notifier);
-#endif
+	register_netdevice_notifier(&tc956xmac_notifier);
+#endif
+}
+
+static void tc956xmac_exit_fs(struct net_device *dev)
+{
+	struct tc956xmac_priv *priv = netdev_priv(dev);
+#ifndef TC956X
+	unregister_netdevice_notifier(&tc956xmac_notifier);
+#endif
+	debugfs_remove_recursive(priv->dbgfs_dir);
+}
+#endif /* CONFIG_DEBUG_FS */
+
+#ifndef TC956X
+static u32 tc956xmac_vid_crc32_le(__le16 vid_le)
+{
+	unsigned char *data = (unsigned char *)&vid_le;
+	unsigned char data_byte = 0;
+	u32 crc = ~0x0;
+	u32 temp = 0;
+	int i, bits;
+
+	bits = get_bitmask_order(VLAN_VID_MASK);
+	for (i = 0; i < bits; i++) {
+		if ((i % 8) == 0)
+			data_byte = data[i / 8];
+
+		temp = ((crc & 1) ^ data_byte) & 1;
+		crc >>= 1;
+		data_byte >>= 1;
+
+		if (temp)
+			crc ^= 0xedb88320;
+	}
+
+	return crc;
+}
+#endif
+
+static int tc956xmac_vlan_rx_add_vid(struct net_device *ndev, __be16 proto,
+				  u16 vid)
+{
+	struct tc956xmac_priv *priv = netdev_priv(ndev);
+	bool is_double = false;
+	int ret = 0;
+
+	if (be16_to_cpu(proto) == ETH_P_8021AD)
+		is_double = true;
+
+	tc956xmac_update_vlan_hash(priv, ndev, is_double, vid, PF_DRIVER);
+
+	return ret;
+}
+
+static int tc956xmac_vlan_rx_kill_vid(struct net_device *ndev, __be16 proto,
+				   u16 vid)
+{
+	struct tc956xmac_priv *priv = netdev_priv(ndev);
+	int ret = 0;
+
+	tc956xmac_delete_vlan(priv, ndev, vid, PF_DRIVER);
+	return ret;
+}
+
+/**
+ * tc956xmac_xdp_setup_prog - attach or detach an XDP program
+ * @priv: driver private structure
+ * @prog: new program, NULL to detach
+ * @extack: netlink extended ack
+ * Description: the RX buffers layout (headroom, DMA direction, split header)
+ * depends on XDP being enabled, so the rings are rebuilt when the program
+ * is added or removed on a running interface.
+ */
+static int tc956xmac_xdp_setup_prog(struct tc956xmac_priv *priv,
+				    struct bpf_prog *prog,
+				    struct netlink_ext_ack *extack)
+{
+	struct net_device *dev = priv->dev;
+	struct bpf_prog *old_prog;
+	bool need_update, if_running;
+
+	if (prog && dev->mtu > ETH_DATA_LEN) {
+		NL_SET_ERR_MSG_MOD(extack, "Jumbo frames not supported by XDP");
+		return -EOPNOTSUPP;
+	}
+
+	if_running = netif_running(dev);
+	need_update = !!priv->xdp_prog != !!prog;
+	if (if_running && need_update)
+		tc956xmac_release(dev);
+
+	old_prog = xchg(&priv->xdp_prog, prog);
+	if (old_prog)
+		bpf_prog_put(old_prog);
+
+	/* Split header is not compatible with XDP */
+	priv->sph = priv->dma_cap.sphen && priv->plat->sph_en &&
+		    !tc956xmac_xdp_is_enabled(priv);
+
+	if (if_running && need_update)
+		return tc956xmac_open(dev);
+
+	return 0;
+}
+
+/**
+ * tc956xmac_xsk_umem_dma_map - map an AF_XDP UMEM for the DMA
+ * @priv: driver private structure
+ * @umem: UMEM registered by the socket
+ */
+static int tc956xmac_xsk_umem_dma_map(struct tc956xmac_priv *priv,
+				      struct xdp_umem *umem)
+{
+	dma_addr_t dma;
+	u32 i;
+
+	for (i = 0; i < umem->npgs; i++) {
+		dma = dma_map_page_attrs(priv->device, umem->pgs[i], 0,
+					 PAGE_SIZE, DMA_BIDIRECTIONAL,
+					 DMA_ATTR_SKIP_CPU_SYNC);
+		if (dma_mapping_error(priv->device, dma))
+			goto out_unmap;
+
+		umem->pages[i].dma = dma;
+	}
+
+	return 0;
+
+out_unmap:
+	while (i--) {
+		dma_unmap_page_attrs(priv->device, umem->pages[i].dma,
+				     PAGE_SIZE, DMA_BIDIRECTIONAL,
+				     DMA_ATTR_SKIP_CPU_SYNC);
+		umem->pages[i].dma = 0;
+	}
+
+	return -ENOMEM;
+}
+
+/**
+ * tc956xmac_xsk_umem_dma_unmap - release the DMA mapping of an AF_XDP UMEM
+ * @priv: driver private structure
+ * @umem: UMEM registered by the socket
+ */
+static void tc956xmac_xsk_umem_dma_unmap(struct tc956xmac_priv *priv,
+					 struct xdp_umem *umem)
+{
+	u32 i;
+
+	for (i = 0; i < umem->npgs; i++) {
+		dma_unmap_page_attrs(priv->device, umem->pages[i].dma,
+				     PAGE_SIZE, DMA_BIDIRECTIONAL,
+				     DMA_ATTR_SKIP_CPU_SYNC);
+		umem->pages[i].dma = 0;
+	}
+}
+
+/**
+ * tc956xmac_xsk_umem_setup - bind or unbind an AF_XDP socket to a channel
+ * @priv: driver private structure
+ * @umem: UMEM of the socket, NULL to unbind
+ * @qid: DMA channel the socket is bound to
+ * Description: only channels owned by the host on both directions can be
+ * handed to a socket. The other channels keep running through the stack
+ * but, as for the XDP program, the rings are rebuilt on a running
+ * interface.
+ */
+static int tc956xmac_xsk_umem_setup(struct tc956xmac_priv *priv,
+				    struct xdp_umem *umem, u16 qid)
+{
+	struct net_device *dev = priv->dev;
+	struct xdp_umem_fq_reuse *reuseq;
+	bool enable = !!umem;
+	bool if_running;
+	int ret;
+
+	if (qid >= priv->plat->rx_queues_to_use ||
+	    qid >= priv->plat->tx_queues_to_use ||
+	    priv->plat->rx_dma_ch_owner[qid] != USE_IN_TC956X_SW ||
+	    priv->plat->tx_dma_ch_owner[qid] != USE_IN_TC956X_SW)
+		return -EINVAL;
+
+	if (enable) {
+		if (test_bit(qid, &priv->af_xdp_zc_qps))
+			return -EBUSY;
+
+		/* A received frame must fit in one chunk */
+		if (umem->chunk_size_nohr - XDP_PACKET_HEADROOM <
+		    priv->dma_buf_sz)
+			return -EINVAL;
+
+		/* Sized for the largest ring, ethtool -G may grow it later */
+		reuseq = xsk_reuseq_prepare(DMA_MAX_RX_SIZE);
+		if (!reuseq)
+			return -ENOMEM;
+		xsk_reuseq_free(xsk_reuseq_swap(umem, reuseq));
+
+		ret = tc956xmac_xsk_umem_dma_map(priv, umem);
+		if (ret)
+			return ret;
+	} else {
+		umem = xdp_get_umem_from_qid(dev, qid);
+		if (!umem || !test_bit(qid, &priv->af_xdp_zc_qps))
+			return -EINVAL;
+	}
+
+	if_running = netif_running(dev) && tc956xmac_xdp_is_enabled(priv);
+	if (if_running)
+		tc956xmac_release(dev);
+
+	if (enable) {
+		set_bit(qid, &priv->af_xdp_zc_qps);
+	} else {
+		clear_bit(qid, &priv->af_xdp_zc_qps);
+		tc956xmac_xsk_umem_dma_unmap(priv, umem);
+	}
+
+	if (if_running) {
+		ret = tc956xmac_open(dev);
+		if (ret || !enable)
+			return ret;
+
+		/* Userspace usually fills the ring after binding, have NAPI
+		 * pick the chunks up or ask for a wakeup.
+		 */
+		if (xsk_umem_uses_need_wakeup(umem))
+			xsk_set_rx_need_wakeup(umem);
+
+		local_bh_disable();
+		napi_schedule(&priv->channel[qid].rx_napi);
+		local_bh_enable();
+	}
+
+	return 0;
 }
 
-static void tc956xmac_exit_fs(struct net_device *dev)
+static int tc956xmac_bpf(struct net_device *dev, struct netdev_bpf *bpf)
 {
 	struct tc956xmac_priv *priv = netdev_priv(dev);
-#ifndef TC956X
-	unregister_netdevice_notifier(&tc956xmac_notifier);
-#endif
-	debugfs_remove_recursive(priv->dbgfs_dir);
+
+	switch (bpf->command) {
+	case XDP_SETUP_PROG:
+		return tc956xmac_xdp_setup_prog(priv, bpf->prog, bpf->extack);
+	case XDP_QUERY_PROG:
+		bpf->prog_id = priv->xdp_prog ? priv->xdp_prog->aux->id : 0;
+		return 0;
+	case XDP_SETUP_XSK_UMEM:
+		return tc956xmac_xsk_umem_setup(priv, bpf->xsk.umem,
+						bpf->xsk.queue_id);
+	default:
+		return -EINVAL;
+	}
 }
-#endif /* CONFIG_DEBUG_FS */
 
-#ifndef TC956X
-static u32 tc956xmac_vid_crc32_le(__le16 vid_le)
+static int tc956xmac_xdp_xmit(struct net_device *dev, int num_frames,
+			      struct xdp_frame **frames, u32 flags)
 {
-	unsigned char *data = (unsigned char *)&vid_le;
-	unsigned char data_byte = 0;
-	u32 crc = ~0x0;
-	u32 temp = 0;
-	int i, bits;
+	struct tc956xmac_priv *priv = netdev_priv(dev);
+	int cpu = smp_processor_id();
+	struct netdev_queue *nq;
+	int i, drops = 0;
+	u32 queue;
 
-	bits = get_bitmask_order(VLAN_VID_MASK);
-	for (i = 0; i < bits; i++) {
-		if ((i % 8) == 0)
-			data_byte = data[i / 8];
+	if (unlikely(!netif_running(dev) || !netif_carrier_ok(dev)))
+		return -ENETDOWN;
 
-		temp = ((crc & 1) ^ data_byte) & 1;
-		crc >>= 1;
-		data_byte >>= 1;
+	if (unlikely(flags & ~XDP_XMIT_FLAGS_MASK))
+		return -EINVAL;
 
-		if (temp)
-			crc ^= 0xedb88320;
+	queue = tc956xmac_xdp_get_tx_queue(priv, cpu);
+	nq = netdev_get_tx_queue(dev, queue);
+
+	__netif_tx_lock(nq, cpu);
+	/* Avoids TX time-out as we are sharing with slow path */
+	txq_trans_update(nq);
+
+	for (i = 0; i < num_frames; i++) {
+		if (tc956xmac_xdp_xmit_xdpf(priv, queue, frames[i], true) !=
+		    TC956XMAC_XDP_TX) {
+			xdp_return_frame_rx_napi(frames[i]);
+			drops++;
+			continue;
+		}
+		priv->xstats.tx_xdp_xmit[queue]++;
 	}
 
-	return crc;
+	if (flags & XDP_XMIT_FLUSH)
+		tc956xmac_flush_tx_descriptors(priv, queue);
+
+	__netif_tx_unlock(nq);
+
+	return num_frames - drops;
 }
-#endif
 
-static int tc956xmac_vlan_rx_add_vid(struct net_device *ndev, __be16 proto,
-				  u16 vid)
+/**
+ * tc956xmac_xsk_wakeup - kick the NAPI of a channel bound to an AF_XDP socket
+ * @dev: net device structure
+ * @queue: DMA channel the socket is bound to
+ * @flags: XDP_WAKEUP_RX and/or XDP_WAKEUP_TX
+ */
+static int tc956xmac_xsk_wakeup(struct net_device *dev, u32 queue, u32 flags)
 {
-	struct tc956xmac_priv *priv = netdev_priv(ndev);
-	bool is_double = false;
-	int ret = 0;
+	struct tc956xmac_priv *priv = netdev_priv(dev);
+	struct tc956xmac_channel *ch;
 
-	if (be16_to_cpu(proto) == ETH_P_8021AD)
-		is_double = true;
+	if (!netif_running(dev) || !netif_carrier_ok(dev))
+		return -ENETDOWN;
 
-	tc956xmac_update_vlan_hash(priv, ndev, is_double, vid, PF_DRIVER);
+	if (!tc956xmac_xdp_is_enabled(priv))
+		return -ENXIO;
 
-	return ret;
-}
+	if (queue >= priv->plat->rx_queues_to_use ||
+	    queue >= priv->plat->tx_queues_to_use)
+		return -EINVAL;
 
-static int tc956xmac_vlan_rx_kill_vid(struct net_device *ndev, __be16 proto,
-				   u16 vid)
-{
-	struct tc956xmac_priv *priv = netdev_priv(ndev);
-	int ret = 0;
+	if (!priv->rx_queue[queue].xsk_umem || !priv->tx_queue[queue].xsk_umem)
+		return -ENXIO;
 
-	tc956xmac_delete_vlan(priv, ndev, vid, PF_DRIVER);
-	return ret;
+	ch = &priv->channel[queue];
+
+	if ((flags & XDP_WAKEUP_RX) && !napi_if_scheduled_mark_missed(&ch->rx_napi))
+		napi_schedule(&ch->rx_napi);
+
+	if ((flags & XDP_WAKEUP_TX) && !napi_if_scheduled_mark_missed(&ch->tx_napi))
+		napi_schedule(&ch->tx_napi);
+
+	return 0;
 }
 
 static const struct net_device_ops tc956xmac_netdev_ops = {
@@ -8893,6 +11134,7 @@ static const struct net_device_ops tc956xmac_netdev_ops = {
 	.ndo_fix_features = tc956xmac_fix_features,
 	.ndo_set_features = tc956xmac_set_features,
 	.ndo_set_rx_mode = tc956xmac_set_rx_mode,
+	.ndo_get_stats64 = tc956xmac_get_stats64,
 	.ndo_tx_timeout = tc956xmac_tx_timeout,
 	.ndo_do_ioctl = tc956xmac_ioctl,
 	.ndo_setup_tc = tc956xmac_setup_tc,
@@ -8905,6 +11147,9 @@ static const struct net_device_ops tc956xmac_netdev_ops = {
 	.ndo_set_mac_address = tc956xmac_set_mac_address,
 	.ndo_vlan_rx_add_vid = tc956xmac_vlan_rx_add_vid,
 	.ndo_vlan_rx_kill_vid = tc956xmac_vlan_rx_kill_vid,
+	.ndo_bpf = tc956xmac_bpf,
+	.ndo_xdp_xmit = tc956xmac_xdp_xmit,
+	.ndo_xsk_wakeup = tc956xmac_xsk_wakeup,
 };
 
 #ifdef TC956X_UNSUPPORTED_UNTESTED
@@ -9310,6 +11555,227 @@ static void parse_config_file(void)
 }
 #endif
 
+/**
+ * tc956xmac_reinit_ringparam - change the number of descriptors per ring
+ * @dev: net device structure
+ * @rx_size: new RX ring length
+ * @tx_size: new TX ring length
+ * Description: the lengths are applied to every host owned DMA channel. The
+ * rings are rebuilt if the interface is running.
+ * Return:
+ * returns 0 on success, otherwise errno.
+ */
+int tc956xmac_reinit_ringparam(struct net_device *dev, u32 rx_size, u32 tx_size)
+{
+	struct tc956xmac_priv *priv = netdev_priv(dev);
+	int ret = 0;
+
+	if (netif_running(dev))
+		tc956xmac_release(dev);
+
+	priv->dma_rx_size = rx_size;
+	priv->dma_tx_size = tx_size;
+
+	if (netif_running(dev))
+		ret = tc956xmac_open(dev);
+
+	return ret;
+}
+
+/**
+ * tc956xmac_reinit_rx_page_split - switch the page aligned split header mode
+ * @dev: net device structure
+ * @enable: true to receive the payload in whole pages at offset 0
+ * Description: the RX buffer size follows the mode, so the rings are rebuilt
+ * if the interface is running.
+ * Return:
+ * returns 0 on success, otherwise errno.
+ */
+int tc956xmac_reinit_rx_page_split(struct net_device *dev, bool enable)
+{
+	struct tc956xmac_priv *priv = netdev_priv(dev);
+	int ret = 0;
+
+	if (priv->rx_page_split == enable)
+		return 0;
+
+	if (enable && (!priv->sph || PAGE_SIZE > BUF_SIZE_8KiB))
+		return -EOPNOTSUPP;
+
+	if (netif_running(dev))
+		tc956xmac_release(dev);
+
+	priv->rx_page_split = enable;
+
+	if (netif_running(dev))
+		ret = tc956xmac_open(dev);
+
+	return ret;
+}
+
+#ifdef TC956X
+/**
+ * tc956xmac_reinit_queues - change the number of host owned DMA channels
+ * @dev: net device structure
+ * @rx_cnt: number of RX channels
+ * @tx_cnt: number of TX channels
+ * Description: the host takes the lowest channels no offloader is using. The
+ * MTL queues of the platform configuration keep their setup. Extra RX
+ * channels are only reached through RSS, extra TX channels get their own
+ * MTL queue. The offloader queues then keep their TX FIFO and the rest is
+ * split evenly between the other queues. The rings are rebuilt if the
+ * interface is running.
+ * Return:
+ * returns 0 on success, otherwise errno.
+ */
+int tc956xmac_reinit_queues(struct net_device *dev, u32 rx_cnt, u32 tx_cnt)
+{
+	struct tc956xmac_priv *priv = netdev_priv(dev);
+	struct plat_tc956xmacenet_data *plat = priv->plat;
+	enum ch_owner rx_owner[MTL_MAX_RX_QUEUES];
+	enum ch_owner tx_owner[MTL_MAX_TX_QUEUES];
+	u32 rx_queues = priv->mtl_rx_queues;
+	u32 tx_queues = priv->mtl_tx_queues;
+	u32 tx_fifo_split = 0, tx_fifo = 0, tx_split_cnt = 0;
+	bool rx_removed = false;
+	u32 chan, i;
+	int ret = 0;
+
+	/* AF_XDP sockets are bound to their channel */
+	if (priv->af_xdp_zc_qps)
+		return -EBUSY;
+
+	memcpy(rx_owner, plat->rx_dma_ch_owner, sizeof(rx_owner));
+	memcpy(tx_owner, plat->tx_dma_ch_owner, sizeof(tx_owner));
+
+	for (chan = 0; chan < min_t(u32, dev->num_rx_queues, MTL_MAX_RX_QUEUES);
+	     chan++) {
+		if (rx_owner[chan] == USE_IN_OFFLOADER)
+			continue;
+
+		if (rx_cnt) {
+			rx_owner[chan] = USE_IN_TC956X_SW;
+			rx_queues = max(rx_queues, chan + 1);
+			rx_cnt--;
+		} else {
+			rx_owner[chan] = NOT_USED;
+			if (chan < plat->rx_queues_to_use &&
+			    plat->rx_dma_ch_owner[chan] == USE_IN_TC956X_SW)
+				rx_removed = true;
+		}
+	}
+
+	for (chan = 0; chan < min_t(u32, dev->num_tx_queues, MTL_MAX_TX_QUEUES);
+	     chan++) {
+		if (tx_owner[chan] == USE_IN_OFFLOADER)
+			continue;
+
+		if (tx_cnt) {
+			tx_owner[chan] = USE_IN_TC956X_SW;
+			tx_queues = max(tx_queues, chan + 1);
+			tx_cnt--;
+		} else {
+			tx_owner[chan] = NOT_USED;
+		}
+	}
+
+	if (rx_cnt || tx_cnt)
+		return -EINVAL;
+
+	/* Steering rules and a user RSS table may point at a removed channel */
+	if (rx_removed && tc956xmac_rxp_has_rules(priv)) {
+		netdev_err(dev, "RX steering rules use the channels\n");
+		return -EBUSY;
+	}
+
+	if (netif_is_rxfh_configured(dev)) {
+		for (i = 0; i < ARRAY_SIZE(priv->rss.table); i++) {
+			if (rx_owner[priv->rss.table[i]] != USE_IN_TC956X_SW) {
+				netdev_err(dev, "RSS table uses removed channels\n");
+				return -EBUSY;
+			}
+		}
+	}
+
+	if (tx_queues > priv->mtl_tx_queues) {
+		for (i = 0; i < MTL_MAX_TX_QUEUES; i++)
+			tx_fifo += tc956xmac_tx_queue_fifo_size(i);
+		for (i = 0; i < tx_queues; i++) {
+			if (tx_owner[i] == USE_IN_OFFLOADER)
+				tx_fifo -= tc956xmac_tx_queue_fifo_size(i);
+			else
+				tx_split_cnt++;
+		}
+		tx_fifo_split = rounddown(tx_fifo / tx_split_cnt, 256);
+
+		if (!tc956xmac_tx_fifo_fits(tx_fifo_split, dev->mtu)) {
+			netdev_err(dev, "MTU %d does not fit the TX FIFO of %d queues\n",
+				   dev->mtu, tx_queues);
+			return -EINVAL;
+		}
+	}
+
+	if (netif_running(dev))
+		tc956xmac_release(dev);
+
+	/* NAPI contexts follow the channel ownership */
+	for (chan = 0; chan < TC956XMAC_CH_MAX; chan++) {
+		struct tc956xmac_channel *ch = &priv->channel[chan];
+		bool was_rx = chan < plat->rx_queues_to_use &&
+			      plat->rx_dma_ch_owner[chan] == USE_IN_TC956X_SW;
+		bool was_tx = chan < plat->tx_queues_to_use &&
+			      plat->tx_dma_ch_owner[chan] == USE_IN_TC956X_SW;
+		bool is_rx = chan < rx_queues &&
+			     rx_owner[chan] == USE_IN_TC956X_SW;
+		bool is_tx = chan < tx_queues &&
+			     tx_owner[chan] == USE_IN_TC956X_SW;
+
+		if (was_rx && !is_rx)
+			netif_napi_del(&ch->rx_napi);
+		else if (!was_rx && is_rx)
+			netif_napi_add(dev, &ch->rx_napi, tc956xmac_napi_poll_rx,
+				       NAPI_POLL_WEIGHT);
+
+		if (was_tx && !is_tx) {
+			netif_napi_del(&ch->tx_napi);
+			priv->tx_be_mask &= ~BIT(chan);
+		} else if (!was_tx && is_tx) {
+			netif_tx_napi_add(dev, &ch->tx_napi,
+					  tc956xmac_napi_poll_tx,
+					  NAPI_POLL_WEIGHT);
+			priv->tx_be_mask |= BIT(chan);
+		}
+	}
+
+	/* MTL queues past the platform ones carry best-effort traffic */
+	for (i = priv->mtl_tx_queues; i < tx_queues; i++) {
+		plat->tx_queues_cfg[i].mode_to_use = MTL_QUEUE_DCB;
+		plat->tx_queues_cfg[i].tso_en =
+			plat->tx_queues_cfg[HOST_BEST_EFF_CH].tso_en;
+	}
+
+	memcpy(plat->rx_dma_ch_owner, rx_owner, sizeof(rx_owner));
+	memcpy(plat->tx_dma_ch_owner, tx_owner, sizeof(tx_owner));
+	plat->rx_queues_to_use = rx_queues;
+	plat->tx_queues_to_use = tx_queues;
+	priv->tx_fifo_split = tx_fifo_split;
+
+	netif_set_real_num_rx_queues(dev, rx_queues);
+	netif_set_real_num_tx_queues(dev, tx_queues);
+
+	if (!netif_is_rxfh_configured(dev))
+		tc956xmac_rss_default_table(priv);
+#ifdef TC956X
+	tc956xmac_init_be_queues(priv);
+#endif
+
+	if (netif_running(dev))
+		ret = tc956xmac_open(dev);
+
+	return ret;
+}
+#endif
+
 /**
  * tc956xmac_dvr_probe
  * @device: device pointer
@@ -9326,7 +11792,7 @@ int tc956xmac_dvr_probe(struct device *device,
 {
 	struct net_device *ndev = NULL;
 	struct tc956xmac_priv *priv;
-	u32 queue, rxq, maxq;
+	u32 queue, maxq;
 	int i, ret = 0;
 	u8 tx_ch_count, rx_ch_count;
 	u32 mac_offset_base = res->port_num == RM_PF0_ID ?
@@ -9380,6 +11846,8 @@ int tc956xmac_dvr_probe(struct device *device,
 	priv->tc956x_SFR_pci_base_addr = res->tc956x_SFR_pci_base_addr;
 	priv->tc956x_SRAM_pci_base_addr = res->tc956x_SRAM_pci_base_addr;
 	priv->tc956x_BRIDGE_CFG_pci_base_addr = res->tc956x_BRIDGE_CFG_pci_base_addr;
+	priv->fw_crc = res->fw_crc;
+	priv->fw_ver = res->fw_ver;
 #endif
 	priv->port_num = res->port_num;
 	priv->dev->base_addr = (unsigned long)res->addr;
@@ -9387,6 +11855,9 @@ int tc956xmac_dvr_probe(struct device *device,
 	priv->dev->irq = res->irq;
 	priv->wol_irq = res->wol_irq;
 	priv->lpi_irq = res->lpi_irq;
+#ifdef TC956X
+	priv->msi_multi_vec = res->msi_multi_vec;
+#endif
 
 #ifdef DMA_OFFLOAD_ENABLE
 	priv->client_priv = NULL;
@@ -9492,7 +11963,10 @@ int tc956xmac_dvr_probe(struct device *device,
 
 	if ((priv->plat->tso_en) && (priv->dma_cap.tsoen)) {
 		ndev->hw_features |= NETIF_F_TSO | NETIF_F_TSO6;
-		if (priv->plat->has_gmac4)
+		/* The TSO engine segments UDP as well, with an 8 byte L4
+		 * header.
+		 */
+		if (priv->plat->has_gmac4 || priv->plat->has_xgmac)
 			ndev->hw_features |= NETIF_F_GSO_UDP_L4;
 		priv->tso = true;
 		dev_info(priv->device, "TSO feature enabled\n");
@@ -9500,6 +11974,13 @@ int tc956xmac_dvr_probe(struct device *device,
 		priv->tso = false;
 	}
 
+	priv->mtl_rx_queues = priv->plat->rx_queues_to_use;
+	priv->mtl_tx_queues = priv->plat->tx_queues_to_use;
+#ifdef TC956X
+	priv->tx_be_mask = tx_be_queues;
+	tc956xmac_init_be_queues(priv);
+#endif
+
 	if (priv->dma_cap.sphen && priv->plat->sph_en) {
 		ndev->hw_features |= NETIF_F_GRO;
 		priv->sph = true;
@@ -9565,15 +12046,22 @@ int tc956xmac_dvr_probe(struct device *device,
 		goto error_hw_init;
 	}
 	priv->msg_enable = netif_msg_init(debug, default_msg_level);
+	priv->rx_copybreak = TC956XMAC_RX_COPYBREAK;
+	priv->tx_copybreak = TC956XMAC_TX_COPYBREAK;
+	INIT_WORK(&priv->chan_reset_task, tc956xmac_chan_reset_task);
+
+	priv->dma_tx_size = DMA_DEFAULT_TX_SIZE;
+	priv->dma_rx_size = DMA_DEFAULT_RX_SIZE;
+	tc956xmac_default_coalesce(priv);
 
-	/* Initialize RSS */
-	rxq = priv->plat->rx_queues_to_use;
+	/* Initialize RSS, only the host owned Rx channels are used */
 	netdev_rss_key_fill(priv->rss.key, sizeof(priv->rss.key));
-	for (i = 0; i < ARRAY_SIZE(priv->rss.table); i++)
-		priv->rss.table[i] = ethtool_rxfh_indir_default(i, rxq);
+	tc956xmac_rss_default_table(priv);
 
-	if (priv->dma_cap.rssen && priv->plat->rss_en)
+	if (priv->dma_cap.rssen && priv->plat->rss_en) {
+		ndev->hw_features |= NETIF_F_RXHASH;
 		ndev->features |= NETIF_F_RXHASH;
+	}
 
 	/* MTU range: 46 - hw-specific max */
 	ndev->min_mtu = ETH_ZLEN - ETH_HLEN;
@@ -9599,15 +12087,27 @@ int tc956xmac_dvr_probe(struct device *device,
 	if (flow_ctrl)
 		priv->flow_ctrl = FLOW_AUTO;/* RX/TX pause on */
 
-	/* Setup channels NAPI */
+	/* Setup channels NAPI. All the channels are initialized, ethtool -L
+	 * may hand any of them to the host later.
+	 */
 	maxq = max(priv->plat->rx_queues_to_use, priv->plat->tx_queues_to_use);
 
-	for (queue = 0; queue < maxq; queue++) {
+	for (queue = 0; queue < TC956XMAC_CH_MAX; queue++) {
 		struct tc956xmac_channel *ch = &priv->channel[queue];
 
 		spin_lock_init(&ch->lock);
 		ch->priv_data = priv;
 		ch->index = queue;
+		u64_stats_init(&priv->rx_queue[queue].rxq_stats.syncp);
+		u64_stats_init(&priv->tx_queue[queue].txq_stats.syncp);
+		u64_stats_init(&priv->tx_queue[queue].txq_stats.napi_syncp);
+		INIT_WORK(&ch->rx_dim.work, tc956xmac_rx_dim_work);
+		ch->rx_dim.mode = DIM_CQ_PERIOD_MODE_START_FROM_EQE;
+		INIT_WORK(&ch->tx_dim.work, tc956xmac_tx_dim_work);
+		ch->tx_dim.mode = DIM_CQ_PERIOD_MODE_START_FROM_EQE;
+#ifdef TC956X
+		ch->irq = priv->msi_multi_vec ? res->ch_irq[queue] : 0;
+#endif
 
 		if ((queue < priv->plat->rx_queues_to_use) &&
 			(priv->plat->rx_dma_ch_owner[queue] == USE_IN_TC956X_SW)) {
@@ -9779,6 +12279,7 @@ int tc956xmac_dvr_remove(struct device *dev)
 	tc956xmac_mac_set(priv, priv->ioaddr, false);
 	netif_carrier_off(ndev);
 	unregister_netdev(ndev);
+	cancel_work_sync(&priv->chan_reset_task);
 	phylink_destroy(priv->phylink);
 
 	kfree(priv->mac_table);
@@ -9809,6 +12310,74 @@ int tc956xmac_dvr_remove(struct device *dev)
 }
 EXPORT_SYMBOL_GPL(tc956xmac_dvr_remove);
 
+/**
+ * tc956xmac_suspend_rings - quiesce the interface without freeing its rings
+ * @priv: driver private structure
+ * Description: NAPI is stopped and every RX descriptor is given a buffer, so
+ * that resume only has to re-arm the rings. The channel reset work is
+ * stopped first, it takes rtnl and reallocates rings too. On failure NAPI is
+ * restarted and the caller falls back to closing the interface.
+ */
+static int tc956xmac_suspend_rings(struct tc956xmac_priv *priv)
+{
+	u32 queue;
+	int ret = 0;
+
+	set_bit(TC956XMAC_DOWN, &priv->state);
+	cancel_work_sync(&priv->chan_reset_task);
+
+	rtnl_lock();
+
+	/* Zero-copy buffers belong to the UMEM fill queue */
+	if (priv->af_xdp_zc_qps) {
+		ret = -EBUSY;
+		goto err_unlock;
+	}
+
+	tc956xmac_disable_all_queues(priv);
+
+	for (queue = 0; queue < priv->plat->rx_queues_to_use; queue++) {
+		if (priv->plat->rx_dma_ch_owner[queue] != USE_IN_TC956X_SW)
+			continue;
+
+		ret = tc956xmac_rx_ring_fill(priv, queue);
+		if (ret) {
+			tc956xmac_enable_all_queues(priv);
+			goto err_unlock;
+		}
+	}
+
+	rtnl_unlock();
+
+	return 0;
+
+err_unlock:
+	clear_bit(TC956XMAC_DOWN, &priv->state);
+	rtnl_unlock();
+	return ret;
+}
+
+/**
+ * tc956xmac_suspend_tx_reclaim - drop the frames pending on the TX rings
+ * @priv: driver private structure
+ * Description: called once the DMA is stopped, the descriptors are left
+ * clean for resume.
+ */
+static void tc956xmac_suspend_tx_reclaim(struct tc956xmac_priv *priv)
+{
+	u32 queue;
+
+	for (queue = 0; queue < priv->plat->tx_queues_to_use; queue++) {
+		if (priv->plat->tx_dma_ch_owner[queue] != USE_IN_TC956X_SW)
+			continue;
+
+		del_timer_sync(&priv->tx_queue[queue].txtimer);
+		dma_free_tx_skbufs(priv, queue);
+		tc956xmac_clear_tx_descriptors(priv, queue);
+		netdev_tx_reset_queue(netdev_get_tx_queue(priv->dev, queue));
+	}
+}
+
 /**
  * tc956xmac_suspend - suspend callback
  * @dev: device pointer
@@ -9831,8 +12400,15 @@ int tc956xmac_suspend(struct device *dev)
 	/* Intimate MAC state change to phylink */
 	phylink_mac_change(priv->phylink, false);
 
+	/* Keep the rings and page pools allocated and mapped, resume then
+	 * only replays the register configuration. Close the interface
+	 * when they cannot be kept.
+	 */
+	priv->pm_fast_resume = netif_running(ndev) &&
+			       !tc956xmac_suspend_rings(priv);
+
 	/* Invoke device driver close */
-	if (netif_running(ndev)) {
+	if (netif_running(ndev) && !priv->pm_fast_resume) {
 		rtnl_lock();
 		dev_close(ndev);
 		rtnl_unlock();
@@ -9856,6 +12432,13 @@ int tc956xmac_suspend(struct device *dev)
 	/* Stop TX/RX DMA */
 	tc956xmac_stop_all_dma(priv);
 
+	if (priv->pm_fast_resume) {
+		if (priv->eee_enabled)
+			del_timer_sync(&priv->eee_ctrl_timer);
+		netif_tx_disable(ndev);
+		tc956xmac_suspend_tx_reclaim(priv);
+	}
+
 	/* Power management Not Applicable for TC956X */
 #ifndef TC956X
 	/* Enable Power down mode by programming the PMT regs */
@@ -9916,6 +12499,7 @@ static void tc956xmac_reset_queues_param(struct tc956xmac_priv *priv)
 
 		tx_q->cur_tx = 0;
 		tx_q->dirty_tx = 0;
+		tx_q->tail_tx = 0;
 		tx_q->mss = 0;
 	}
 }
@@ -9931,6 +12515,7 @@ int tc956xmac_resume(struct device *dev)
 	struct net_device *ndev = dev_get_drvdata(dev);
 	struct tc956xmac_priv *priv = netdev_priv(ndev);
 	struct tc956xmac_resources res;
+	bool reopen = false;
 	s32 ret;
 
 #ifdef TC956X
@@ -9938,6 +12523,8 @@ int tc956xmac_resume(struct device *dev)
 	res.addr = priv->ioaddr;
 	res.tc956x_SRAM_pci_base_addr = priv->tc956x_SRAM_pci_base_addr;
 	res.irq = priv->dev->irq;
+	res.fw_crc = priv->fw_crc;
+	res.fw_ver = priv->fw_ver;
 #endif
 	/* Load Firmare for CM3 */
 	if (priv->port_num == RM_PF0_ID) {
@@ -9946,6 +12533,10 @@ int tc956xmac_resume(struct device *dev)
 			KPRINT_ERR("Firmware load failed\n");
 			return -EINVAL;
 		}
+#ifdef TC956X
+		priv->fw_crc = res.fw_crc;
+		priv->fw_ver = res.fw_ver;
+#endif
 	}
 
 	/* Power Down bit, into the PM register, is cleared
@@ -9981,6 +12572,40 @@ int tc956xmac_resume(struct device *dev)
 
 	/* Reset Tx/Rx Queues */
 	tc956xmac_reset_queues_param(priv);
+
+	if (priv->pm_fast_resume) {
+		u32 queue;
+
+		/* The rings survived suspend, replay the configuration the
+		 * open path would program and restart the DMA.
+		 */
+		for (queue = 0; queue < priv->plat->rx_queues_to_use; queue++) {
+			if (priv->plat->rx_dma_ch_owner[queue] == USE_IN_TC956X_SW)
+				tc956xmac_rx_ring_rearm(priv, queue);
+		}
+
+		ret = tc956xmac_hw_setup(ndev, false);
+		if (ret < 0) {
+			netdev_err(priv->dev, "%s: Hw setup failed, reopening\n",
+				   __func__);
+			/* The close path expects NAPI enabled */
+			tc956xmac_enable_all_queues(priv);
+			reopen = true;
+		} else {
+#ifdef TC956X
+			tc956xmac_msi_config(priv);
+#endif
+			tc956xmac_init_coalesce(priv);
+			tc956xmac_set_rx_mode(ndev);
+
+			clear_bit(TC956XMAC_DOWN, &priv->state);
+			tc956xmac_enable_all_queues(priv);
+#ifdef TC956X
+			tc956xmac_msi_enable(priv);
+#endif
+		}
+		priv->pm_fast_resume = false;
+	}
 #ifndef TC956X
 	/* Clear Descriptors */
 	tc956xmac_clear_descriptors(priv);
@@ -10000,6 +12625,16 @@ int tc956xmac_resume(struct device *dev)
 		rtnl_unlock();
 	}
 
+	/* Rebuild everything when the rings could not be resumed. DOWN was
+	 * set by suspend and neither close nor open clears it.
+	 */
+	if (reopen) {
+		rtnl_lock();
+		dev_close(ndev);
+		clear_bit(TC956XMAC_DOWN, &priv->state);
+		rtnl_unlock();
+	}
+
 	/* Invoke device driver open */
 	if (!netif_running(ndev)) {
 		rtnl_lock();
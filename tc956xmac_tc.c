@@ -32,6 +32,7 @@
  *  VERSION     : 01-00
  */
 
+#include <asm/unaligned.h>
 #include <net/pkt_cls.h>
 #include <net/tc_act/tc_gact.h>
 #include "common.h"
@@ -49,15 +50,14 @@ static void tc_fill_all_pass_entry(struct tc956xmac_tc_entry *entry)
 	entry->val.match_data = 0x0;
 	entry->val.match_en = 0x0;
 	entry->val.af = 1;
+	/* No channel, unmatched frames keep the queue default and RSS */
 	entry->val.dma_ch_no = 0x0;
 }
 
 static struct tc956xmac_tc_entry *tc_find_entry(struct tc956xmac_priv *priv,
-					     struct tc_cls_u32_offload *cls,
-					     bool free)
+					     u32 loc, bool free)
 {
 	struct tc956xmac_tc_entry *entry, *first = NULL, *dup = NULL;
-	u32 loc = cls->knode.handle;
 	int i;
 
 	for (i = 0; i < priv->tc_entries_max; i++) {
@@ -73,14 +73,50 @@ static struct tc956xmac_tc_entry *tc_find_entry(struct tc956xmac_priv *priv,
 	if (first) {
 		first->handle = loc;
 		first->in_use = true;
+		first->seq = priv->rxp_seq++;
 
 		/* Reset HW values */
 		memset(&first->val, 0, sizeof(first->val));
+		first->frag_ptr = NULL;
+		first->is_frag = false;
 	}
 
 	return first;
 }
 
+static void tc_unuse_chain(struct tc956xmac_tc_entry *entry)
+{
+	struct tc956xmac_tc_entry *next;
+
+	for (; entry; entry = next) {
+		next = entry->frag_ptr;
+		entry->frag_ptr = NULL;
+		entry->is_frag = false;
+		entry->in_use = false;
+	}
+}
+
+/**
+ * tc_rxp_commit - write the dynamic entries to the RX parser
+ * @priv: driver private structure
+ * Description: once the last rule is gone the static table configured
+ * through the platform data or the IOCTL is put back.
+ */
+static int tc_rxp_commit(struct tc956xmac_priv *priv)
+{
+	int ret;
+
+	ret = tc956xmac_rxp_config(priv, priv->hw->pcsr, priv->tc_entries,
+			priv->tc_entries_max);
+	if (ret)
+		return ret;
+
+	if (!tc956xmac_rxp_has_rules(priv) && priv->plat->rxp_cfg.enable)
+		return tc956xmac_rx_parser_configuration(priv);
+
+	return 0;
+}
+
 static int tc_fill_actions(struct tc956xmac_tc_entry *entry,
 			   struct tc956xmac_tc_entry *frag,
 			   struct tc_cls_u32_offload *cls)
@@ -148,12 +184,12 @@ static int tc_fill_entry(struct tc956xmac_priv *priv,
 	real_off = off / 4;
 	rem = off % 4;
 
-	entry = tc_find_entry(priv, cls, true);
+	entry = tc_find_entry(priv, cls->knode.handle, true);
 	if (!entry)
 		return -EINVAL;
 
 	if (rem) {
-		frag = tc_find_entry(priv, cls, true);
+		frag = tc_find_entry(priv, cls->knode.handle, true);
 		if (!frag) {
 			ret = -EINVAL;
 			goto err_unuse;
@@ -200,16 +236,11 @@ static void tc_unfill_entry(struct tc956xmac_priv *priv,
 {
 	struct tc956xmac_tc_entry *entry;
 
-	entry = tc_find_entry(priv, cls, false);
+	entry = tc_find_entry(priv, cls->knode.handle, false);
 	if (!entry)
 		return;
 
-	entry->in_use = false;
-	if (entry->frag_ptr) {
-		entry = entry->frag_ptr;
-		entry->is_frag = false;
-		entry->in_use = false;
-	}
+	tc_unuse_chain(entry);
 }
 
 static int tc_config_knode(struct tc956xmac_priv *priv,
@@ -221,8 +252,7 @@ static int tc_config_knode(struct tc956xmac_priv *priv,
 	if (ret)
 		return ret;
 
-	ret = tc956xmac_rxp_config(priv, priv->hw->pcsr, priv->tc_entries,
-			priv->tc_entries_max);
+	ret = tc_rxp_commit(priv);
 	if (ret)
 		goto err_unfill;
 
@@ -241,8 +271,7 @@ static int tc_delete_knode(struct tc956xmac_priv *priv,
 	/* Set entry and fragments as not used */
 	tc_unfill_entry(priv, cls);
 
-	ret = tc956xmac_rxp_config(priv, priv->hw->pcsr, priv->tc_entries,
-			priv->tc_entries_max);
+	ret = tc_rxp_commit(priv);
 	if (ret)
 		return ret;
 
@@ -264,6 +293,299 @@ static int tc_setup_cls_u32(struct tc956xmac_priv *priv,
 		return -EOPNOTSUPP;
 	}
 }
+
+/* Bytes of the frame a key can look at: L2, one VLAN tag, IPv6 and ports */
+#define TC956XMAC_RXP_KEY_LEN		64
+
+struct tc956xmac_rxp_key {
+	u8 data[TC956XMAC_RXP_KEY_LEN];
+	u8 mask[TC956XMAC_RXP_KEY_LEN];
+};
+
+static void tc_key_set(struct tc956xmac_rxp_key *key, unsigned int off,
+		       const void *data, const void *mask, unsigned int len)
+{
+	const u8 *d = data, *m = mask;
+	unsigned int i;
+
+	for (i = 0; i < len; i++) {
+		key->data[off + i] |= d[i] & m[i];
+		key->mask[off + i] |= m[i];
+	}
+}
+
+/**
+ * tc_fill_key_entries - compile a key into a chain of parser entries
+ * @priv: driver private structure
+ * @key: frame bytes to match
+ * @handle: handle the entries are tagged with
+ * @prio: position of the chain in the table, lowest first
+ * @drop: reject matching frames instead of accepting them
+ * @chan: DMA channel accepted frames are steered to, negative to leave them
+ *	  to the queue default and RSS
+ * Description: every 32-bit word of the key with a non-zero mask takes one
+ * entry, the last entry carries the action.
+ * Return: number of entries used or a negative error code.
+ */
+static int tc_fill_key_entries(struct tc956xmac_priv *priv,
+			       struct tc956xmac_rxp_key *key, u32 handle,
+			       u32 prio, bool drop, int chan)
+{
+	struct tc956xmac_tc_entry *entry, *head = NULL, *prev = NULL;
+	bool empty = !memchr_inv(key->mask, 0, sizeof(key->mask));
+	unsigned int off, count = 0;
+	u32 mask;
+
+	for (off = 0; off < TC956XMAC_RXP_KEY_LEN; off += 4) {
+		mask = get_unaligned_le32(&key->mask[off]);
+		/* A rule without any match is a single match-all entry */
+		if (!mask && (!empty || off))
+			continue;
+		if (off + 4 > priv->tc_off_max)
+			goto err_unuse;
+
+		entry = tc_find_entry(priv, handle, true);
+		if (!entry) {
+			tc_unuse_chain(head);
+			return -ENOSPC;
+		}
+
+		entry->val.match_en = mask;
+		entry->val.match_data = get_unaligned_le32(&key->data[off]);
+		entry->val.frame_offset = off / 4;
+		entry->prio = prio;
+
+		if (prev) {
+			prev->frag_ptr = entry;
+			entry->is_frag = true;
+		} else {
+			head = entry;
+		}
+
+		prev = entry;
+		count++;
+	}
+
+	if (drop) {
+		prev->val.rf = 1;
+	} else {
+		prev->val.af = 1;
+		prev->val.dma_ch_no = chan < 0 ? 0 : BIT(chan);
+	}
+
+	return count;
+
+err_unuse:
+	tc_unuse_chain(head);
+	return -EINVAL;
+}
+
+/* The parser DMA channel is only honoured by MTL queues in dynamic channel
+ * selection mode, which is set up along with RSS. Otherwise frames stay on
+ * the static channel of their queue.
+ */
+static bool tc_rxp_can_steer(struct tc956xmac_priv *priv)
+{
+	return priv->rss.enable;
+}
+
+static int tc_rx_nfc_to_key(struct ethtool_rx_flow_spec *fs,
+			    struct tc956xmac_rxp_key *key)
+{
+	u32 flow_type = fs->flow_type & ~(FLOW_EXT | FLOW_MAC_EXT);
+	unsigned int l3 = ETH_HLEN;
+	__be16 ethertype = htons(ETH_P_IP), mask16 = htons(0xffff);
+	u8 ver_ihl = 0x45, ip_proto, mask8 = 0xff;
+	bool ports = false;
+
+	memset(key, 0, sizeof(*key));
+
+	if (fs->flow_type & FLOW_MAC_EXT)
+		tc_key_set(key, 0, fs->h_ext.h_dest, fs->m_ext.h_dest, ETH_ALEN);
+
+	if (fs->flow_type & FLOW_EXT) {
+		__be16 tpid = htons(ETH_P_8021Q);
+
+		if (fs->m_ext.data[0] || fs->m_ext.data[1])
+			return -EOPNOTSUPP;
+
+		if (fs->m_ext.vlan_etype)
+			tpid = fs->h_ext.vlan_etype;
+		if (fs->m_ext.vlan_etype || fs->m_ext.vlan_tci) {
+			tc_key_set(key, 2 * ETH_ALEN, &tpid, &mask16, 2);
+			tc_key_set(key, 2 * ETH_ALEN + 2, &fs->h_ext.vlan_tci,
+				   &fs->m_ext.vlan_tci, 2);
+			l3 += VLAN_HLEN;
+		}
+	}
+
+	switch (flow_type) {
+	case ETHER_FLOW: {
+		struct ethhdr *v = &fs->h_u.ether_spec;
+		struct ethhdr *m = &fs->m_u.ether_spec;
+
+		tc_key_set(key, 0, v->h_dest, m->h_dest, ETH_ALEN);
+		tc_key_set(key, ETH_ALEN, v->h_source, m->h_source, ETH_ALEN);
+		tc_key_set(key, l3 - 2, &v->h_proto, &m->h_proto, 2);
+		return 0;
+	}
+	case TCP_V4_FLOW:
+	case UDP_V4_FLOW:
+	case SCTP_V4_FLOW: {
+		struct ethtool_tcpip4_spec *v = &fs->h_u.tcp_ip4_spec;
+		struct ethtool_tcpip4_spec *m = &fs->m_u.tcp_ip4_spec;
+
+		if (flow_type == TCP_V4_FLOW)
+			ip_proto = IPPROTO_TCP;
+		else if (flow_type == UDP_V4_FLOW)
+			ip_proto = IPPROTO_UDP;
+		else
+			ip_proto = IPPROTO_SCTP;
+
+		tc_key_set(key, l3 + 1, &v->tos, &m->tos, 1);
+		tc_key_set(key, l3 + 9, &ip_proto, &mask8, 1);
+		tc_key_set(key, l3 + 12, &v->ip4src, &m->ip4src, 4);
+		tc_key_set(key, l3 + 16, &v->ip4dst, &m->ip4dst, 4);
+		tc_key_set(key, l3 + 20, &v->psrc, &m->psrc, 2);
+		tc_key_set(key, l3 + 22, &v->pdst, &m->pdst, 2);
+		ports = m->psrc || m->pdst;
+		break;
+	}
+	case IP_USER_FLOW: {
+		struct ethtool_usrip4_spec *v = &fs->h_u.usr_ip4_spec;
+		struct ethtool_usrip4_spec *m = &fs->m_u.usr_ip4_spec;
+
+		if (m->ip_ver)
+			return -EOPNOTSUPP;
+
+		tc_key_set(key, l3 + 1, &v->tos, &m->tos, 1);
+		tc_key_set(key, l3 + 9, &v->proto, &m->proto, 1);
+		tc_key_set(key, l3 + 12, &v->ip4src, &m->ip4src, 4);
+		tc_key_set(key, l3 + 16, &v->ip4dst, &m->ip4dst, 4);
+		tc_key_set(key, l3 + 20, &v->l4_4_bytes, &m->l4_4_bytes, 4);
+		ports = !!m->l4_4_bytes;
+		break;
+	}
+	default:
+		return -EOPNOTSUPP;
+	}
+
+	tc_key_set(key, l3 - 2, &ethertype, &mask16, 2);
+	/* Offsets past the IP header only hold without IP options */
+	if (ports)
+		tc_key_set(key, l3, &ver_ihl, &mask8, 1);
+
+	return 0;
+}
+
+static int tc_rx_nfc_fill(struct tc956xmac_priv *priv,
+			  struct ethtool_rx_flow_spec *fs)
+{
+	bool drop = fs->ring_cookie == RX_CLS_FLOW_DISC;
+	struct tc956xmac_rxp_key key;
+	u32 chan = 0;
+	int ret;
+
+	ret = tc_rx_nfc_to_key(fs, &key);
+	if (ret)
+		return ret;
+
+	if (!drop)
+		chan = ethtool_get_flow_spec_ring(fs->ring_cookie);
+
+	/* Locations are below tc u32 priorities, so ntuple rules go first */
+	return tc_fill_key_entries(priv, &key,
+				   TC956XMAC_RX_NFC_HANDLE(fs->location),
+				   fs->location, drop, chan);
+}
+
+static void tc_rx_nfc_unfill(struct tc956xmac_priv *priv, u32 loc)
+{
+	tc_unuse_chain(tc_find_entry(priv, TC956XMAC_RX_NFC_HANDLE(loc),
+				     false));
+}
+
+static int tc_rx_nfc_ins(struct tc956xmac_priv *priv,
+			 struct ethtool_rx_flow_spec *fs)
+{
+	struct tc956xmac_rx_nfc_rule *rule;
+	u32 loc = fs->location;
+	int ret;
+
+	if (loc >= TC956XMAC_RX_NFC_MAX)
+		return -EINVAL;
+
+	if (fs->ring_cookie != RX_CLS_FLOW_DISC) {
+		u32 ring = ethtool_get_flow_spec_ring(fs->ring_cookie);
+
+		if (ethtool_get_flow_spec_ring_vf(fs->ring_cookie))
+			return -EINVAL;
+		if (ring >= priv->plat->rx_queues_to_use ||
+		    priv->plat->rx_dma_ch_owner[ring] != USE_IN_TC956X_SW)
+			return -EINVAL;
+		if (!tc_rxp_can_steer(priv))
+			return -EOPNOTSUPP;
+	}
+
+	rule = &priv->rx_nfc[loc];
+	if (rule->in_use)
+		tc_rx_nfc_unfill(priv, loc);
+
+	ret = tc_rx_nfc_fill(priv, fs);
+	if (ret < 0) {
+		/* The old rule fitted in the entries just released */
+		if (rule->in_use)
+			tc_rx_nfc_fill(priv, &rule->fs);
+		return ret;
+	}
+
+	if (!rule->in_use)
+		priv->rx_nfc_count++;
+	rule->in_use = true;
+	rule->entries = ret;
+	rule->fs = *fs;
+
+	ret = tc_rxp_commit(priv);
+	if (ret) {
+		tc_rx_nfc_unfill(priv, loc);
+		rule->in_use = false;
+		priv->rx_nfc_count--;
+		return ret;
+	}
+
+	return 0;
+}
+
+static int tc_rx_nfc_del(struct tc956xmac_priv *priv, u32 loc)
+{
+	struct tc956xmac_rx_nfc_rule *rule;
+
+	if (loc >= TC956XMAC_RX_NFC_MAX || !priv->rx_nfc[loc].in_use)
+		return -ENOENT;
+
+	rule = &priv->rx_nfc[loc];
+	tc_rx_nfc_unfill(priv, loc);
+	rule->in_use = false;
+	priv->rx_nfc_count--;
+
+	return tc_rxp_commit(priv);
+}
+
+static int tc_setup_rxnfc(struct tc956xmac_priv *priv,
+			  struct ethtool_rxnfc *cmd)
+{
+	if (!priv->tc_entries)
+		return -EOPNOTSUPP;
+
+	switch (cmd->cmd) {
+	case ETHTOOL_SRXCLSRLINS:
+		return tc_rx_nfc_ins(priv, &cmd->fs);
+	case ETHTOOL_SRXCLSRLDEL:
+		return tc_rx_nfc_del(priv, cmd->fs.location);
+	default:
+		return -EOPNOTSUPP;
+	}
+}
 #endif /* TC956X_UNSUPPORTED_UNTESTED_FEATURE */
 
 static int tc_init(struct tc956xmac_priv *priv, void *data)
@@ -320,19 +642,32 @@ static int tc_init(struct tc956xmac_priv *priv, void *data)
 		return -EINVAL;
 	}
 
-	/* Reserve one last filter which lets all pass */
-	priv->tc_entries_max = count;
-	priv->tc_entries = devm_kcalloc(priv->device,
-			count, sizeof(*priv->tc_entries), GFP_KERNEL);
-	if (!priv->tc_entries)
+	/* Rules sharing a prefix share its HW entries, so there are more
+	 * fragments than HW entries. Reserve one last filter which lets all
+	 * pass.
+	 */
+	priv->tc_entries_max = count * TC956XMAC_RXP_SW_RATIO;
+	priv->tc_entries = devm_kcalloc(priv->device, priv->tc_entries_max,
+			sizeof(*priv->tc_entries), GFP_KERNEL);
+	priv->rxp_order = devm_kcalloc(priv->device, priv->tc_entries_max,
+			sizeof(*priv->rxp_order), GFP_KERNEL);
+	if (!priv->tc_entries || !priv->rxp_order)
+		return -ENOMEM;
+
+	priv->rxp_hw_size = count;
+	priv->rxp_hw = devm_kcalloc(priv->device,
+			count, sizeof(*priv->rxp_hw), GFP_KERNEL);
+	priv->rxp_next = devm_kcalloc(priv->device,
+			count, sizeof(*priv->rxp_next), GFP_KERNEL);
+	if (!priv->rxp_hw || !priv->rxp_next)
 		return -ENOMEM;
 
 #ifdef TC956X_UNSUPPORTED_UNTESTED_FEATURE
-	tc_fill_all_pass_entry(&priv->tc_entries[count - 1]);
+	tc_fill_all_pass_entry(&priv->tc_entries[priv->tc_entries_max - 1]);
 #endif /* TC956X_UNSUPPORTED_UNTESTED_FEATURE */
 
 	dev_info(priv->device, "Enabling HW TC (entries=%d, max_off=%d)\n",
-			priv->tc_entries_max, priv->tc_off_max);
+			priv->rxp_hw_size, priv->tc_off_max);
 	return 0;
 }
 
@@ -564,6 +899,281 @@ static struct {
 	{ .fn = tc_add_ports_flow },
 };
 
+static int tc_flow_rxp_action(struct tc956xmac_priv *priv,
+			      struct flow_cls_offload *cls,
+			      bool *drop, int *chan)
+{
+	struct flow_rule *rule = flow_cls_offload_flow_rule(cls);
+	struct flow_action_entry *act;
+	int i;
+
+	*drop = false;
+	*chan = -1;
+
+	/* hw_tc picks the RX DMA channel */
+	if (TC_H_MIN(cls->classid) >= TC_H_MIN_PRIORITY)
+		*chan = TC_H_MIN(cls->classid) - TC_H_MIN_PRIORITY;
+
+	flow_action_for_each(i, act, &rule->action) {
+		switch (act->id) {
+		case FLOW_ACTION_ACCEPT:
+			break;
+		case FLOW_ACTION_DROP:
+			*drop = true;
+			break;
+		case FLOW_ACTION_QUEUE:
+			*chan = act->queue.index;
+			break;
+#if (LINUX_VERSION_CODE >= KERNEL_VERSION(6, 0, 0))
+		case FLOW_ACTION_RX_QUEUE_MAPPING:
+			*chan = act->rx_queue;
+			break;
+#endif
+		default:
+			return -EOPNOTSUPP;
+		}
+	}
+
+	if (*chan < 0)
+		return 0;
+	if (*chan >= priv->plat->rx_queues_to_use ||
+	    priv->plat->rx_dma_ch_owner[*chan] != USE_IN_TC956X_SW)
+		return -EINVAL;
+
+	return 0;
+}
+
+static int tc_flow_to_key(struct flow_cls_offload *cls,
+			  struct tc956xmac_rxp_key *key)
+{
+	struct flow_rule *rule = flow_cls_offload_flow_rule(cls);
+	u8 ver_ihl = 0x45, ip_proto_mask = 0, mask8 = 0xff;
+	__be16 n_proto = 0, mask16 = htons(0xffff);
+	unsigned int l3 = ETH_HLEN, l4;
+
+	if (rule->match.dissector->used_keys &
+	    ~(BIT(FLOW_DISSECTOR_KEY_CONTROL) |
+	      BIT(FLOW_DISSECTOR_KEY_BASIC) |
+	      BIT(FLOW_DISSECTOR_KEY_ETH_ADDRS) |
+	      BIT(FLOW_DISSECTOR_KEY_VLAN) |
+	      BIT(FLOW_DISSECTOR_KEY_IPV4_ADDRS) |
+	      BIT(FLOW_DISSECTOR_KEY_IPV6_ADDRS) |
+	      BIT(FLOW_DISSECTOR_KEY_PORTS)))
+		return -EOPNOTSUPP;
+
+	memset(key, 0, sizeof(*key));
+
+	if (flow_rule_match_key(rule, FLOW_DISSECTOR_KEY_ETH_ADDRS)) {
+		struct flow_match_eth_addrs match;
+
+		flow_rule_match_eth_addrs(rule, &match);
+		tc_key_set(key, 0, match.key->dst, match.mask->dst, ETH_ALEN);
+		tc_key_set(key, ETH_ALEN, match.key->src, match.mask->src,
+			   ETH_ALEN);
+	}
+
+	if (flow_rule_match_key(rule, FLOW_DISSECTOR_KEY_VLAN)) {
+		struct flow_match_vlan match;
+		__be16 tpid = htons(ETH_P_8021Q), tci, tci_mask;
+
+		flow_rule_match_vlan(rule, &match);
+		if (match.mask->vlan_tpid)
+			tpid = match.key->vlan_tpid;
+		tci = htons(match.key->vlan_id |
+			    match.key->vlan_priority << VLAN_PRIO_SHIFT);
+		tci_mask = htons(match.mask->vlan_id |
+				 match.mask->vlan_priority << VLAN_PRIO_SHIFT);
+
+		tc_key_set(key, 2 * ETH_ALEN, &tpid, &mask16, 2);
+		tc_key_set(key, 2 * ETH_ALEN + 2, &tci, &tci_mask, 2);
+		l3 += VLAN_HLEN;
+	}
+
+	if (flow_rule_match_key(rule, FLOW_DISSECTOR_KEY_BASIC)) {
+		struct flow_match_basic match;
+
+		flow_rule_match_basic(rule, &match);
+		tc_key_set(key, l3 - 2, &match.key->n_proto,
+			   &match.mask->n_proto, 2);
+		n_proto = match.key->n_proto & match.mask->n_proto;
+
+		switch (ntohs(n_proto)) {
+		case ETH_P_IP:
+			tc_key_set(key, l3 + 9, &match.key->ip_proto,
+				   &match.mask->ip_proto, 1);
+			break;
+		case ETH_P_IPV6:
+			tc_key_set(key, l3 + 6, &match.key->ip_proto,
+				   &match.mask->ip_proto, 1);
+			break;
+		}
+		ip_proto_mask = match.mask->ip_proto;
+	}
+
+	switch (ntohs(n_proto)) {
+	case ETH_P_IP:
+		if (flow_rule_match_key(rule, FLOW_DISSECTOR_KEY_IPV4_ADDRS)) {
+			struct flow_match_ipv4_addrs match;
+
+			flow_rule_match_ipv4_addrs(rule, &match);
+			tc_key_set(key, l3 + 12, &match.key->src,
+				   &match.mask->src, 4);
+			tc_key_set(key, l3 + 16, &match.key->dst,
+				   &match.mask->dst, 4);
+		}
+		l4 = l3 + 20;
+		break;
+	case ETH_P_IPV6:
+		if (flow_rule_match_key(rule, FLOW_DISSECTOR_KEY_IPV6_ADDRS)) {
+			struct flow_match_ipv6_addrs match;
+
+			flow_rule_match_ipv6_addrs(rule, &match);
+			tc_key_set(key, l3 + 8, &match.key->src,
+				   &match.mask->src, 16);
+			tc_key_set(key, l3 + 24, &match.key->dst,
+				   &match.mask->dst, 16);
+		}
+		l4 = l3 + 40;
+		break;
+	default:
+		if (flow_rule_match_key(rule, FLOW_DISSECTOR_KEY_IPV4_ADDRS) ||
+		    flow_rule_match_key(rule, FLOW_DISSECTOR_KEY_IPV6_ADDRS) ||
+		    flow_rule_match_key(rule, FLOW_DISSECTOR_KEY_PORTS))
+			return -EOPNOTSUPP;
+		return 0;
+	}
+
+	if (flow_rule_match_key(rule, FLOW_DISSECTOR_KEY_PORTS)) {
+		struct flow_match_ports match;
+
+		/* Ports sit right after a fixed size header: the IPv4 header
+		 * must carry no options and the IPv6 next header must be the
+		 * L4 protocol itself.
+		 */
+		if (ip_proto_mask != 0xff)
+			return -EOPNOTSUPP;
+		if (ntohs(n_proto) == ETH_P_IP)
+			tc_key_set(key, l3, &ver_ihl, &mask8, 1);
+
+		flow_rule_match_ports(rule, &match);
+		tc_key_set(key, l4, &match.key->src, &match.mask->src, 2);
+		tc_key_set(key, l4 + 2, &match.key->dst, &match.mask->dst, 2);
+	}
+
+	return 0;
+}
+
+/* The L3/L4 filters only drop IPv4 flows and are bypassed by RSS */
+static bool tc_flow_use_rxp(struct tc956xmac_priv *priv,
+			    struct flow_cls_offload *cls)
+{
+	struct flow_rule *rule = flow_cls_offload_flow_rule(cls);
+	bool drop;
+	int chan;
+
+	if (priv->rss.enable)
+		return true;
+	if (TC_H_MIN(cls->classid) >= TC_H_MIN_PRIORITY)
+		return true;
+	if (flow_rule_match_key(rule, FLOW_DISSECTOR_KEY_IPV6_ADDRS) ||
+	    flow_rule_match_key(rule, FLOW_DISSECTOR_KEY_ETH_ADDRS) ||
+	    flow_rule_match_key(rule, FLOW_DISSECTOR_KEY_VLAN))
+		return true;
+	if (tc_flow_rxp_action(priv, cls, &drop, &chan))
+		return false;
+
+	return chan >= 0;
+}
+
+static struct tc956xmac_rxp_flow *tc_find_rxp_flow(struct tc956xmac_priv *priv,
+						   unsigned long cookie,
+						   bool get_free)
+{
+	struct tc956xmac_rxp_flow *flow, *first = NULL;
+	int i;
+
+	for (i = 0; i < TC956XMAC_RXP_FLOW_MAX; i++) {
+		flow = &priv->rxp_flows[i];
+
+		if (flow->in_use && flow->cookie == cookie)
+			return flow;
+		if (get_free && !flow->in_use && !first)
+			first = flow;
+	}
+
+	return first;
+}
+
+static void tc_unfill_rxp_flow(struct tc956xmac_priv *priv,
+			       struct tc956xmac_rxp_flow *flow)
+{
+	u32 handle = TC956XMAC_RXP_FLOW_HANDLE(flow - priv->rxp_flows);
+
+	tc_unuse_chain(tc_find_entry(priv, handle, false));
+	flow->in_use = false;
+	flow->steer = false;
+	flow->cookie = 0;
+}
+
+static int tc_add_rxp_flow(struct tc956xmac_priv *priv,
+			   struct flow_cls_offload *cls)
+{
+	struct tc956xmac_rxp_flow *flow;
+	struct tc956xmac_rxp_key key;
+	bool drop, replaced = false;
+	int chan, ret;
+	u32 handle;
+
+	if (!priv->tc_entries)
+		return -EOPNOTSUPP;
+
+	ret = tc_flow_rxp_action(priv, cls, &drop, &chan);
+	if (ret)
+		return ret;
+	if (!drop && chan >= 0 && !tc_rxp_can_steer(priv))
+		return -EOPNOTSUPP;
+
+	ret = tc_flow_to_key(cls, &key);
+	if (ret)
+		return ret;
+
+	flow = tc_find_rxp_flow(priv, cls->cookie, false);
+	if (flow) {
+		tc_unfill_rxp_flow(priv, flow);
+		replaced = true;
+	}
+
+	flow = tc_find_rxp_flow(priv, cls->cookie, true);
+	if (!flow) {
+		ret = -ENOSPC;
+		goto err_commit;
+	}
+
+	/* Plain accept picks no channel, the queue default and RSS apply */
+	handle = TC956XMAC_RXP_FLOW_HANDLE(flow - priv->rxp_flows);
+	ret = tc_fill_key_entries(priv, &key, handle, cls->common.prio << 16,
+				  drop, chan);
+	if (ret < 0)
+		goto err_commit;
+
+	flow->in_use = true;
+	flow->steer = !drop && chan >= 0;
+	flow->entries = ret;
+	flow->cookie = cls->cookie;
+
+	ret = tc_rxp_commit(priv);
+	if (ret)
+		tc_unfill_rxp_flow(priv, flow);
+
+	return ret;
+
+err_commit:
+	/* A replaced rule is gone, keep the table in line with it */
+	if (replaced)
+		tc_rxp_commit(priv);
+	return ret;
+}
+
 static int tc_add_flow(struct tc956xmac_priv *priv,
 		       struct flow_cls_offload *cls)
 {
@@ -571,6 +1181,9 @@ static int tc_add_flow(struct tc956xmac_priv *priv,
 	struct flow_rule *rule = flow_cls_offload_flow_rule(cls);
 	int i, ret;
 
+	if (tc_flow_use_rxp(priv, cls))
+		return tc_add_rxp_flow(priv, cls);
+
 	if (!entry) {
 		entry = tc_find_flow(priv, cls, true);
 		if (!entry)
@@ -600,8 +1213,15 @@ static int tc_del_flow(struct tc956xmac_priv *priv,
 		       struct flow_cls_offload *cls)
 {
 	struct tc956xmac_flow_entry *entry = tc_find_flow(priv, cls, false);
+	struct tc956xmac_rxp_flow *flow;
 	int ret;
 
+	flow = tc_find_rxp_flow(priv, cls->cookie, false);
+	if (flow) {
+		tc_unfill_rxp_flow(priv, flow);
+		return tc_rxp_commit(priv);
+	}
+
 	if (!entry || !entry->in_use)
 		return -ENOENT;
 
@@ -624,10 +1244,6 @@ static int tc_setup_cls(struct tc956xmac_priv *priv,
 {
 	int ret = 0;
 
-	/* When RSS is enabled, the filtering will be bypassed */
-	if (priv->rss.enable)
-		return -EBUSY;
-
 	switch (cls->command) {
 	case FLOW_CLS_REPLACE:
 		ret = tc_add_flow(priv, cls);
@@ -814,5 +1430,6 @@ const struct tc956xmac_tc_ops dwmac510_tc_ops = {
 	.setup_cls = tc_setup_cls,
 	.setup_taprio = tc_setup_taprio,
 	.setup_etf = tc_setup_etf,
+	.setup_rxnfc = tc_setup_rxnfc,
 #endif /* TC956X_UNSUPPORTED_UNTESTED_FEATURE */
 };